@@ -0,0 +1,270 @@
+// core/coord.cpp
+// Coordinate and symmetry tables; see coord.h.
+
+#include "coord.h"
+
+// ============================================================================
+// PDB ENCODING
+// ============================================================================
+
+void decode_permutation_8(int index, array<uint8_t,8> &perm) {
+    unrank_perm8(index, perm.data());
+}
+
+void decode_orientation_corners(int index, array<uint8_t,8> &ori) {
+    int sum = 0;
+    for(int i=6; i>=0; i--) {
+        ori[i] = index % 3;
+        sum += ori[i];
+        index /= 3;
+    }
+    ori[7] = (3 - sum % 3) % 3;
+}
+
+void decode_edge_korf(long long index, int k, uint8_t *pos, uint8_t *ori) {
+    for(int i=k-1; i>=0; i--) {
+        ori[i] = index & 1;
+        index >>= 1;
+    }
+    unrank_partial(index, k, 12, pos);
+}
+
+// ============================================================================
+// COORDINATE MOVE TABLES
+// ============================================================================
+
+uint16_t cperm_move[N_CPERM][18];
+uint16_t cori_move[N_CORI][18];
+uint16_t edge3_move[N_EDGE3][18];
+Edge3Cubies edge3_decode[N_EDGE3];
+CoordCube coord_solved;
+uint8_t edge_to[18][12];
+uint8_t edge_flip[18][12];
+
+int encode_edge3(const uint8_t pos[3], const uint8_t ori[3]) {
+    int p1 = pos[1] - (pos[1] > pos[0]);
+    int p2 = pos[2] - (pos[2] > pos[0]) - (pos[2] > pos[1]);
+    int perm_idx = (pos[0] * 11 + p1) * 10 + p2;
+    return perm_idx * 8 + ori[0] * 4 + ori[1] * 2 + ori[2];
+}
+
+CoordCube to_coord(const CubieCube &c) {
+    CoordCube r;
+    r.cperm = encode_permutation_8(c.cp);
+    r.cori = encode_orientation_corners(c.co);
+    uint8_t pos[12], ori[12];
+    for(int i=0; i<12; i++) {
+        pos[c.ep[i]] = i;
+        ori[c.ep[i]] = c.eo[i];
+    }
+    for(int k=0; k<4; k++) r.edge3[k] = encode_edge3(pos + 3*k, ori + 3*k);
+    return r;
+}
+
+CubieCube from_coord(const CoordCube &c) {
+    CubieCube r;
+    decode_permutation_8(c.cperm, r.cp);
+    decode_orientation_corners(c.cori, r.co);
+    for(int k=0; k<4; k++) {
+        const Edge3Cubies &d = edge3_decode[c.edge3[k]];
+        for(int j=0; j<3; j++) {
+            r.ep[d.pos[j]] = 3*k + j;
+            r.eo[d.pos[j]] = d.ori[j];
+        }
+    }
+    return r;
+}
+
+void init_coord_tables() {
+    for(int m=0; m<18; m++) {
+        const CubieCube &mv = move_cube[m];
+        for(int i=0; i<12; i++) {
+            edge_to[m][mv.ep[i]] = i;
+            edge_flip[m][mv.ep[i]] = mv.eo[i];
+        }
+    }
+
+    for(int idx=0; idx<N_EDGE3; idx++) {
+        int perm_idx = idx / 8;
+        Edge3Cubies &d = edge3_decode[idx];
+        d.ori[0] = (idx >> 2) & 1;
+        d.ori[1] = (idx >> 1) & 1;
+        d.ori[2] = idx & 1;
+        int p0 = perm_idx / 110, p1 = perm_idx / 10 % 11, p2 = perm_idx % 10;
+        p1 += (p1 >= p0);
+        for(int s : {min(p0, p1), max(p0, p1)}) p2 += (p2 >= s);
+        d.pos[0] = p0; d.pos[1] = p1; d.pos[2] = p2;
+    }
+
+    for(int m=0; m<18; m++) {
+        const CubieCube &mv = move_cube[m];
+        for(int idx=0; idx<N_CPERM; idx++) {
+            CubieCube c;
+            decode_permutation_8(idx, c.cp);
+            cperm_move[idx][m] = encode_permutation_8((c * mv).cp);
+        }
+        for(int idx=0; idx<N_CORI; idx++) {
+            CubieCube c;
+            decode_orientation_corners(idx, c.co);
+            cori_move[idx][m] = encode_orientation_corners((c * mv).co);
+        }
+        for(int idx=0; idx<N_EDGE3; idx++) {
+            const Edge3Cubies &d = edge3_decode[idx];
+            uint8_t pos[3], ori[3];
+            for(int j=0; j<3; j++) {
+                pos[j] = edge_to[m][d.pos[j]];
+                ori[j] = d.ori[j] ^ edge_flip[m][d.pos[j]];
+            }
+            edge3_move[idx][m] = encode_edge3(pos, ori);
+        }
+    }
+
+    coord_solved = to_coord(CubieCube::solved());
+}
+
+// ============================================================================
+// SYMMETRIES
+// ============================================================================
+
+CubieCube sym_cube[N_SYM];
+int sym_inv[N_SYM];
+uint8_t sym_move[N_SYM][18];
+uint16_t cperm_class[N_CPERM];
+uint8_t cperm_sym[N_CPERM];
+uint16_t cperm_rep[N_CPERM_CLASS];
+uint16_t cperm_rep_stab[N_CPERM_CLASS];
+uint16_t cori_conj[N_CORI][N_SYM_UD];
+EdgeConj edge_conj[N_SYM];
+
+CubieCube sym_multiply(const CubieCube &a, const CubieCube &b) {
+    CubieCube r;
+    for(int i=0; i<8; i++) {
+        r.cp[i] = a.cp[b.cp[i]];
+        int oa = a.co[b.cp[i]], ob = b.co[i], o;
+        if(oa < 3 && ob < 3) {
+            o = (oa + ob) % 3;
+        } else if(oa < 3) {
+            o = oa + ob;
+            if(o >= 6) o -= 3;
+        } else if(ob < 3) {
+            o = oa - ob;
+            if(o < 3) o += 3;
+        } else {
+            o = oa - ob;
+            if(o < 0) o += 3;
+        }
+        r.co[i] = o;
+    }
+    for(int i=0; i<12; i++) {
+        r.ep[i] = a.ep[b.ep[i]];
+        r.eo[i] = a.eo[b.ep[i]] ^ b.eo[i];
+    }
+    return r;
+}
+
+void init_sym_tables() {
+    CubieCube urf3, f2, u4, lr2;
+    urf3.cp = {0, 4, 5, 1, 3, 7, 6, 2};
+    urf3.co = {1, 2, 1, 2, 2, 1, 2, 1};
+    urf3.ep = {1, 8, 5, 9, 3, 11, 7, 10, 0, 4, 6, 2};
+    urf3.eo = {1, 0, 1, 0, 1, 0, 1, 0, 1, 1, 1, 1};
+    f2.cp = {5, 4, 7, 6, 1, 0, 3, 2};
+    f2.ep = {6, 5, 4, 7, 2, 1, 0, 3, 9, 8, 11, 10};
+    u4.cp = {3, 0, 1, 2, 7, 4, 5, 6};
+    u4.ep = {3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10};
+    u4.eo = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1};
+    lr2.cp = {1, 0, 3, 2, 5, 4, 7, 6};
+    lr2.co = {3, 3, 3, 3, 3, 3, 3, 3};
+    lr2.ep = {2, 1, 0, 3, 6, 5, 4, 7, 9, 8, 11, 10};
+
+    CubieCube c = CubieCube::solved();
+    int n = 0;
+    for(int i=0; i<3; i++) {
+        for(int j=0; j<2; j++) {
+            for(int k=0; k<4; k++) {
+                for(int l=0; l<2; l++) {
+                    sym_cube[n++] = c;
+                    c = sym_multiply(c, lr2);
+                }
+                c = sym_multiply(c, u4);
+            }
+            c = sym_multiply(c, f2);
+        }
+        c = sym_multiply(c, urf3);
+    }
+    for(int s=0; s<N_SYM; s++) {
+        for(int t=0; t<N_SYM; t++) {
+            if(sym_multiply(sym_cube[s], sym_cube[t]).is_solved()) {
+                sym_inv[s] = t;
+                break;
+            }
+        }
+    }
+    
+    // The move set is closed under conjugation, mirrors included
+    for(int s=0; s<N_SYM; s++) {
+        for(int m=0; m<18; m++) {
+            CubieCube conj = sym_conjugate(s, move_cube[m]);
+            for(int m2=0; m2<18; m2++) {
+                if(same_cube(conj, move_cube[m2])) {
+                    sym_move[s][m] = m2;
+                    break;
+                }
+            }
+        }
+    }
+
+    for(int s=0; s<N_SYM; s++) {
+        const CubieCube &a = sym_cube[s], &b = sym_cube[sym_inv[s]];
+        EdgeConj &e = edge_conj[s];
+        for(int t=0; t<12; t++) {
+            e.src[t] = b.ep[t];
+            e.slot[t] = a.ep[t];
+        }
+        for(int t=0; t<12; t++) {
+            for(int j=0; j<12; j++) e.flip[t][j] = a.eo[e.src[t]] ^ b.eo[a.ep[j]];
+        }
+    }
+
+    // Corner permutation classes; the representative is the smallest cperm
+    int classes = 0;
+    for(int idx=0; idx<N_CPERM; idx++) {
+        CubieCube x;
+        decode_permutation_8(idx, x.cp);
+        int best = idx, best_sym = 0;
+        for(int s=1; s<N_SYM_UD; s++) {
+            int conj = encode_permutation_8(sym_conjugate(s, x).cp);
+            if(conj < best) { best = conj; best_sym = s; }
+        }
+        if(best == idx) cperm_rep[classes++] = idx;
+        cperm_sym[idx] = best_sym;
+    }
+    for(int idx=0; idx<N_CPERM; idx++) {
+        CubieCube x;
+        decode_permutation_8(idx, x.cp);
+        int rep = encode_permutation_8(sym_conjugate(cperm_sym[idx], x).cp);
+        cperm_class[idx] = lower_bound(cperm_rep, cperm_rep + classes, rep) - cperm_rep;
+    }
+    // A representative fixed by some symmetries has several twist entries
+    // for one class; gen_pdb fills all of them
+    for(int cls=0; cls<N_CPERM_CLASS; cls++) {
+        CubieCube x;
+        decode_permutation_8(cperm_rep[cls], x.cp);
+        cperm_rep_stab[cls] = 0;
+        for(int s=0; s<N_SYM_UD; s++) {
+            if(encode_permutation_8(sym_conjugate(s, x).cp) == cperm_rep[cls]) {
+                cperm_rep_stab[cls] |= 1 << s;
+            }
+        }
+    }
+
+    // The U/D symmetries twist every corner alike, so conjugating cori does
+    // not depend on cperm
+    for(int idx=0; idx<N_CORI; idx++) {
+        CubieCube x;
+        decode_orientation_corners(idx, x.co);
+        for(int s=0; s<N_SYM_UD; s++) {
+            cori_conj[idx][s] = encode_orientation_corners(sym_conjugate(s, x).co);
+        }
+    }
+}
@@ -0,0 +1,178 @@
+// core/coord.h
+// Integer coordinates of the cube: the PDB encoders, the coordinate move
+// tables the search steps through, and the 48 cube symmetries. gen_pdb and the
+// solver index their tables through these same functions.
+
+#pragma once
+
+#include "cube.h"
+#include "rank.h"
+
+// ============================================================================
+// PDB ENCODING
+// ============================================================================
+
+inline int encode_permutation_8(const array<uint8_t,8> &perm) {
+    return rank_perm8(perm.data());
+}
+
+inline int encode_orientation_corners(const array<uint8_t,8> &ori) {
+    int index = 0;
+    for(int i=0; i<7; i++) {
+        index = index * 3 + ori[i];
+    }
+    return index;
+}
+
+void decode_permutation_8(int index, array<uint8_t,8> &perm);
+void decode_orientation_corners(int index, array<uint8_t,8> &ori);
+
+// Legacy edge subset: permutation and flips of the cubies in six slots
+// (edges_a: slots 0-5, UR UF UL UB DR DF; edges_b: slots 6-11, DL DB FR FL BL BR)
+inline int encode_edge_subset(const array<uint8_t,12> &ep, const array<uint8_t,12> &eo,
+                              const array<int,6> &subset) {
+    array<uint8_t,6> perm;
+    array<uint8_t,6> ori;
+
+    for(int i=0; i<6; i++) {
+        perm[i] = ep[subset[i]];
+        ori[i] = eo[subset[i]];
+    }
+
+    int perm_idx = rank_relative(perm.data(), 6);
+
+    int ori_idx = 0;
+    for(int i=0; i<5; i++) {
+        ori_idx = ori_idx * 2 + ori[i];
+    }
+
+    return perm_idx * 32 + ori_idx;
+}
+
+// Korf-style edge pattern: slots and flips of k chosen edge cubies across all
+// 12 slots. Index = rank of the slot tuple in 12Pk, times 2^k, plus flip bits.
+// edges6_a: cubies 0-5, edges6_b: 6-11, edges7_a: 0-6, edges7_b: 5-11
+inline long long korf_edge_states(int k) {
+    long long n = 1;
+    for(int i=0; i<k; i++) n *= 12 - i;
+    return n << k;
+}
+
+inline long long encode_edge_korf(const uint8_t *pos, const uint8_t *ori, int k) {
+    long long perm_idx = rank_partial(pos, k, 12);
+
+    int ori_idx = 0;
+    for(int i=0; i<k; i++) {
+        ori_idx = ori_idx * 2 + ori[i];
+    }
+
+    return (perm_idx << k) | ori_idx;
+}
+
+void decode_edge_korf(long long index, int k, uint8_t *pos, uint8_t *ori);
+
+// ============================================================================
+// COORDINATE MOVE TABLES
+// ============================================================================
+// The search works on integer coordinates instead of CubieCube:
+//   cperm - corner permutation, same numbering as encode_permutation_8 (8!)
+//   cori  - corner orientation, same numbering as encode_orientation_corners (3^7)
+//   edge3 - slots and flips of three edge cubies (12*11*10 * 2^3); four of
+//           them cover cubies {0,1,2} {3,4,5} {6,7,8} {9,10,11}
+// A move is then six lookups in coord x 18 tables, and the corner PDB index
+// is cperm * 2187 + cori with no re-ranking.
+
+const int N_CPERM = 40320;
+const int N_CORI = 2187;
+const int N_EDGE3 = 10560;
+
+struct CoordCube {
+    uint16_t cperm;
+    uint16_t cori;
+    array<uint16_t,4> edge3;
+
+    bool operator==(const CoordCube &o) const {
+        return cperm == o.cperm && cori == o.cori && edge3 == o.edge3;
+    }
+};
+
+struct Edge3Cubies {
+    uint8_t pos[3];
+    uint8_t ori[3];
+};
+
+extern uint16_t cperm_move[N_CPERM][18];
+extern uint16_t cori_move[N_CORI][18];
+extern uint16_t edge3_move[N_EDGE3][18];
+extern Edge3Cubies edge3_decode[N_EDGE3];
+extern CoordCube coord_solved;
+
+// Edge cubie in slot j lands in slot edge_to[m][j] with flip delta edge_flip[m][j]
+extern uint8_t edge_to[18][12];
+extern uint8_t edge_flip[18][12];
+
+int encode_edge3(const uint8_t pos[3], const uint8_t ori[3]);
+CoordCube to_coord(const CubieCube &c);
+CubieCube from_coord(const CoordCube &c);
+void init_coord_tables();
+
+inline CoordCube apply_move_coord(const CoordCube &c, int move) {
+    CoordCube r;
+    r.cperm = cperm_move[c.cperm][move];
+    r.cori = cori_move[c.cori][move];
+    for(int k=0; k<4; k++) r.edge3[k] = edge3_move[c.edge3[k]][move];
+    return r;
+}
+
+// ============================================================================
+// SYMMETRIES
+// ============================================================================
+// The 48 symmetries of the cube, generated as in Kociemba's solver from four
+// basic ones (the slot numbering here is his): S_URF3 (120 deg about the
+// URF-DBL diagonal), S_F2, S_U4 and the mirror S_LR2. Index
+// 16*urf3 + 8*f2 + 2*u4 + lr2, so 0..15 are the symmetries that keep the U/D
+// axis. Mirrored cubes carry corner orientations 3..5, which is why they need
+// sym_multiply instead of CubieCube::operator*.
+//
+// Conjugating by a symmetry (S * X * S^-1) never changes the distance to
+// solved, so a table only has to store one state per class:
+//   corners_sym - cperm reduced to 2768 classes under the 16 U/D symmetries,
+//                 cori conjugated along; 6,053,616 entries instead of 88M
+//   edge lookups - the R/L and F/B axis views of an edge PDB are the U/D view
+//                 of the state conjugated by S_URF3 or S_URF3^2
+
+const int N_SYM = 48;
+const int N_SYM_UD = 16;
+const int N_CPERM_CLASS = 2768;
+const int SYM_URF3 = 16;
+
+extern CubieCube sym_cube[N_SYM];
+extern int sym_inv[N_SYM];
+extern uint8_t sym_move[N_SYM][18];           // S * move * S^-1 as a move
+extern uint16_t cperm_class[N_CPERM];         // class of every corner permutation
+extern uint8_t cperm_sym[N_CPERM];            // U/D symmetry taking it to the representative
+extern uint16_t cperm_rep[N_CPERM_CLASS];
+extern uint16_t cperm_rep_stab[N_CPERM_CLASS];  // U/D symmetries fixing the representative
+extern uint16_t cori_conj[N_CORI][N_SYM_UD];
+
+// Edge cubie t of S * X * S^-1 is cubie src[t] of X, moved to slot[] of its
+// slot in X and flipped by flip[t][slot in X]
+struct EdgeConj {
+    uint8_t src[12];
+    uint8_t slot[12];
+    uint8_t flip[12][12];
+};
+extern EdgeConj edge_conj[N_SYM];
+
+CubieCube sym_multiply(const CubieCube &a, const CubieCube &b);
+
+inline CubieCube sym_conjugate(int s, const CubieCube &c) {
+    return sym_multiply(sym_multiply(sym_cube[s], c), sym_cube[sym_inv[s]]);
+}
+
+void init_sym_tables();
+
+inline long long corner_sym_index(const CoordCube &c) {
+    int s = cperm_sym[c.cperm];
+    return (long long)cperm_class[c.cperm] * N_CORI + cori_conj[c.cori][s];
+}
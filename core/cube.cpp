@@ -0,0 +1,117 @@
+// core/cube.cpp
+// Move names and the packed-cube multiply implementations.
+
+#include "cube.h"
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define PACKED_CUBE_AVX2 1
+#else
+#define PACKED_CUBE_AVX2 0
+#endif
+
+string move_names[18] = {"U", "R", "F", "D", "L", "B",
+                         "U'", "R'", "F'", "D'", "L'", "B'",
+                         "U2", "R2", "F2", "D2", "L2", "B2"};
+
+// ============================================================================
+// PACKED CUBE
+// ============================================================================
+
+PackedCube packed_moves[18];
+
+PackedCube pack_cube(const CubieCube &c) {
+    PackedCube p;
+    for(int i=0; i<16; i++) {
+        p.b[i] = i;
+        p.b[16 + i] = i;
+    }
+    for(int i=0; i<8; i++) p.b[i] = c.cp[i] | c.co[i] << 4;
+    for(int i=0; i<12; i++) p.b[16 + i] = c.ep[i] | c.eo[i] << 4;
+    return p;
+}
+
+CubieCube unpack_cube(const PackedCube &p) {
+    CubieCube c;
+    for(int i=0; i<8; i++) {
+        c.cp[i] = p.b[i] & 0xF;
+        c.co[i] = p.b[i] >> 4;
+    }
+    for(int i=0; i<12; i++) {
+        c.ep[i] = p.b[16 + i] & 0xF;
+        c.eo[i] = p.b[16 + i] >> 4;
+    }
+    return c;
+}
+
+PackedCube packed_multiply_scalar(const PackedCube &a, const PackedCube &b) {
+    PackedCube r;
+    for(int i=0; i<16; i++) {
+        uint8_t c = a.b[b.b[i] & 0xF] + (b.b[i] & 0xF0);
+        r.b[i] = min<uint8_t>(c, c - 0x30);
+        r.b[16 + i] = a.b[16 + (b.b[16 + i] & 0xF)] ^ (b.b[16 + i] & 0xF0);
+    }
+    return r;
+}
+
+#if PACKED_CUBE_AVX2
+__attribute__((target("avx2")))
+PackedCube packed_multiply_avx2(const PackedCube &a, const PackedCube &b) {
+    const __m256i corner_lane = _mm256_setr_epi64x(-1, -1, 0, 0);
+    __m256i va = _mm256_load_si256(reinterpret_cast<const __m256i*>(a.b));
+    __m256i vb = _mm256_load_si256(reinterpret_cast<const __m256i*>(b.b));
+    __m256i ori = _mm256_and_si256(vb, _mm256_set1_epi8((char)0xF0));
+    __m256i r = _mm256_shuffle_epi8(va, vb);
+    r = _mm256_add_epi8(r, _mm256_and_si256(ori, corner_lane));
+    __m256i wrap = _mm256_and_si256(_mm256_set1_epi8(0x30), corner_lane);
+    r = _mm256_min_epu8(r, _mm256_sub_epi8(r, wrap));
+    r = _mm256_xor_si256(r, _mm256_andnot_si256(corner_lane, ori));
+    PackedCube out;
+    _mm256_store_si256(reinterpret_cast<__m256i*>(out.b), r);
+    return out;
+}
+#endif
+
+PackedCube (*packed_multiply)(const PackedCube &, const PackedCube &) = packed_multiply_scalar;
+const char *packed_impl = "scalar";
+
+void init_packed_cube() {
+    for(int m=0; m<18; m++) packed_moves[m] = pack_cube(move_cube[m]);
+#if PACKED_CUBE_AVX2
+    if(__builtin_cpu_supports("avx2")) {
+        packed_multiply = packed_multiply_avx2;
+        packed_impl = "avx2";
+    }
+#endif
+}
+
+// Every available implementation against CubieCube: random walks move by
+// move, products of random cubes, and pack/unpack round trips
+bool packed_self_check() {
+    vector<pair<const char*, PackedCube (*)(const PackedCube &, const PackedCube &)>> impls = {
+        {"scalar", packed_multiply_scalar}};
+#if PACKED_CUBE_AVX2
+    if(__builtin_cpu_supports("avx2")) impls.push_back({"avx2", packed_multiply_avx2});
+#endif
+    bool ok = true;
+    for(const auto &impl : impls) {
+        mt19937 rng(12345);
+        int failures = 0;
+        for(int walk=0; walk<100; walk++) {
+            CubieCube a, b;
+            PackedCube pa = pack_cube(a);
+            for(int i=0; i<100; i++) {
+                int m = rng() % 18;
+                a = apply_move(a, m);
+                pa = impl.second(pa, packed_moves[m]);
+                if(!(pa == pack_cube(a))) failures++;
+                b = apply_move(b, rng() % 18);
+            }
+            if(!same_cube(unpack_cube(pa), a)) failures++;
+            if(!(impl.second(pack_cube(a), pack_cube(b)) == pack_cube(a * b))) failures++;
+        }
+        cout << (failures ? "[FAIL] " : "[OK] ") << "Packed cube (" << impl.first << "): "
+             << failures << " mismatches against CubieCube\n";
+        ok = ok && failures == 0;
+    }
+    return ok;
+}
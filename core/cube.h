@@ -0,0 +1,192 @@
+// core/cube.h
+// The cubie-level cube and its 18 face turns, shared by rubiks_solver, gen_pdb
+// and the benchmark. The move table is constexpr data, so every tool compiles
+// against this one definition and nothing has to be initialised before
+// apply_move works.
+
+#pragma once
+
+#include <bits/stdc++.h>
+using namespace std;
+
+// ============================================================================
+// CUBIE REPRESENTATION
+// ============================================================================
+
+struct CubieCube {
+    array<uint8_t,8> cp;
+    array<uint8_t,8> co;
+    array<uint8_t,12> ep;
+    array<uint8_t,12> eo;
+
+    constexpr CubieCube() : cp(), co(), ep(), eo() {
+        for(int i=0;i<8;i++){cp[i]=i; co[i]=0;}
+        for(int i=0;i<12;i++){ep[i]=i; eo[i]=0;}
+    }
+
+    constexpr CubieCube(const array<uint8_t,8> &cp, const array<uint8_t,8> &co,
+                        const array<uint8_t,12> &ep, const array<uint8_t,12> &eo)
+        : cp(cp), co(co), ep(ep), eo(eo) {}
+
+    static constexpr CubieCube solved(){ return CubieCube(); }
+
+    bool is_solved() const {
+        for(int i=0;i<8;i++) if(cp[i]!=i || co[i]!=0) return false;
+        for(int i=0;i<12;i++) if(ep[i]!=i || eo[i]!=0) return false;
+        return true;
+    }
+
+    constexpr CubieCube operator*(const CubieCube &b) const {
+        CubieCube result;
+        for(int i=0; i<8; i++) {
+            result.cp[i] = cp[b.cp[i]];
+            result.co[i] = (co[b.cp[i]] + b.co[i]) % 3;
+        }
+        for(int i=0; i<12; i++) {
+            result.ep[i] = ep[b.ep[i]];
+            result.eo[i] = (eo[b.ep[i]] + b.eo[i]) % 2;
+        }
+        return result;
+    }
+};
+
+inline bool same_cube(const CubieCube &a, const CubieCube &b) {
+    return a.cp == b.cp && a.co == b.co && a.ep == b.ep && a.eo == b.eo;
+}
+
+// ============================================================================
+// MOVE TABLES
+// ============================================================================
+
+enum Move { U=0, R=1, F=2, D=3, L=4, B=5,
+            Up=6, Rp=7, Fp=8, Dp=9, Lp=10, Bp=11,
+            U2=12, R2=13, F2=14, D2=15, L2=16, B2=17 };
+
+extern string move_names[18];
+
+// The six quarter turns in Move order
+constexpr CubieCube moveTables[6] = {
+    {{1, 2, 3, 0, 4, 5, 6, 7}, {0, 0, 0, 0, 0, 0, 0, 0},
+     {1, 2, 3, 0, 4, 5, 6, 7, 8, 9, 10, 11}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}},
+    {{3, 1, 2, 7, 0, 5, 6, 4}, {2, 0, 0, 1, 1, 0, 0, 2},
+     {11, 1, 2, 3, 8, 5, 6, 7, 0, 9, 10, 4}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}},
+    {{4, 0, 2, 3, 5, 1, 6, 7}, {1, 2, 0, 0, 2, 1, 0, 0},
+     {0, 8, 2, 3, 4, 9, 6, 7, 5, 1, 10, 11}, {0, 1, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0}},
+    {{0, 1, 2, 3, 7, 4, 5, 6}, {0, 0, 0, 0, 0, 0, 0, 0},
+     {0, 1, 2, 3, 7, 4, 5, 6, 8, 9, 10, 11}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}},
+    {{0, 5, 1, 3, 4, 6, 2, 7}, {0, 1, 2, 0, 0, 2, 1, 0},
+     {0, 1, 9, 3, 4, 5, 10, 7, 8, 6, 2, 11}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}},
+    {{0, 1, 6, 2, 4, 5, 7, 3}, {0, 0, 1, 2, 0, 0, 2, 1},
+     {0, 1, 2, 10, 4, 5, 6, 11, 8, 9, 7, 3}, {0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 1}},
+};
+
+// All 18 moves: quarter turn, its cube (prime) and its square (half turn)
+constexpr array<CubieCube,18> build_move_cubes() {
+    array<CubieCube,18> moves{};
+    for(int f=0; f<6; f++) {
+        moves[f] = moveTables[f];
+        moves[12 + f] = moveTables[f] * moveTables[f];
+        moves[6 + f] = moves[12 + f] * moveTables[f];
+    }
+    return moves;
+}
+
+inline constexpr array<CubieCube,18> move_cube = build_move_cubes();
+
+// ============================================================================
+// MOVE APPLICATION
+// ============================================================================
+
+inline CubieCube apply_move(const CubieCube &cube, int move) {
+    return cube * move_cube[move];
+}
+
+// ============================================================================
+// STATE KEY
+// ============================================================================
+// The whole state in 100 bits as fixed-width digits, first slot most
+// significant: hi holds cp (3 bits each) above co (2 bits each), lo holds ep
+// (4 bits each) above eo (1 bit each). Comparing (hi, lo) therefore orders
+// cubes lexicographically by cp, co, ep, eo, and equality and hashing are a
+// few instructions. This is the key for anything that stores whole cubes;
+// the 4.3e19 states need more than 64 bits, so there is no exact 64-bit form,
+// only hash(). IDA* nodes are CoordCubes and keep their own coordinate keys.
+
+inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+struct CubeKey {
+    uint64_t hi = 0;
+    uint64_t lo = 0;
+
+    bool operator==(const CubeKey &o) const { return hi == o.hi && lo == o.lo; }
+    bool operator!=(const CubeKey &o) const { return !(*this == o); }
+    bool operator<(const CubeKey &o) const { return hi != o.hi ? hi < o.hi : lo < o.lo; }
+
+    uint64_t hash() const { return mix64(hi ^ mix64(lo)); }
+};
+
+namespace std {
+template<> struct hash<CubeKey> {
+    size_t operator()(const CubeKey &k) const { return k.hash(); }
+};
+}
+
+inline CubeKey cube_key(const CubieCube &c) {
+    CubeKey k;
+    for(int i=0; i<8; i++) k.hi = k.hi << 3 | c.cp[i];
+    for(int i=0; i<8; i++) k.hi = k.hi << 2 | c.co[i];
+    for(int i=0; i<12; i++) k.lo = k.lo << 4 | c.ep[i];
+    for(int i=0; i<12; i++) k.lo = k.lo << 1 | c.eo[i];
+    return k;
+}
+
+inline CubieCube key_cube(const CubeKey &k) {
+    CubieCube c;
+    uint64_t hi = k.hi, lo = k.lo;
+    for(int i=7; i>=0; i--) { c.co[i] = hi & 3; hi >>= 2; }
+    for(int i=7; i>=0; i--) { c.cp[i] = hi & 7; hi >>= 3; }
+    for(int i=11; i>=0; i--) { c.eo[i] = lo & 1; lo >>= 1; }
+    for(int i=11; i>=0; i--) { c.ep[i] = lo & 15; lo >>= 4; }
+    return c;
+}
+
+// ============================================================================
+// PACKED CUBE
+// ============================================================================
+// The whole cubie state in one 32-byte block: bytes 0-7 hold the corners as
+// cp | co << 4 and bytes 16-27 the edges as ep | eo << 4; the padding bytes
+// map to themselves. a * b is one byte shuffle of a by b (only the low nibble
+// selects), then b's high nibbles are added to the corner twists, reduced
+// mod 3 by an unsigned min, and xor'ed into the edge flips. A shuffle never
+// crosses a 16-byte lane, which is why corners and edges get one lane each:
+// with AVX2 a move is a single vpshufb plus four cheap ops. packed_moves holds
+// all 18 moves, so prime and half turns cost the same as quarter turns.
+// CubieCube stays the reference arithmetic; --self-check compares the two.
+
+struct alignas(32) PackedCube {
+    uint8_t b[32];
+
+    bool operator==(const PackedCube &o) const { return memcmp(b, o.b, sizeof(b)) == 0; }
+};
+
+extern PackedCube packed_moves[18];
+
+// Chosen once at startup by init_packed_cube
+extern PackedCube (*packed_multiply)(const PackedCube &, const PackedCube &);
+extern const char *packed_impl;
+
+PackedCube pack_cube(const CubieCube &c);
+CubieCube unpack_cube(const PackedCube &p);
+
+inline PackedCube packed_apply_move(const PackedCube &c, int move) {
+    return packed_multiply(c, packed_moves[move]);
+}
+
+void init_packed_cube();
+bool packed_self_check();
@@ -0,0 +1,217 @@
+// core/notation.cpp
+// Move and facelet notation, scrambles and random states; see notation.h.
+
+#include "notation.h"
+
+// ============================================================================
+// MOVE AND FACELET PARSING
+// ============================================================================
+
+string seq_to_string(const vector<int> &seq) {
+    string s;
+    for(size_t i=0; i<seq.size(); i++) {
+        if(i) s += " ";
+        s += move_names[seq[i]];
+    }
+    return s;
+}
+
+// Whitespace-separated move names as printed by seq_to_string
+bool parse_moves(const string &text, vector<int> &seq, string &error) {
+    seq.clear();
+    istringstream in(text);
+    string tok;
+    while(in >> tok) {
+        int m = -1;
+        for(int i=0; i<18; i++) if(tok == move_names[i]) m = i;
+        if(m < 0) {
+            error = "unknown move '" + tok + "'";
+            return false;
+        }
+        seq.push_back(m);
+    }
+    return true;
+}
+
+// Facelet strings use the standard 54-character URFDLB layout (U1..U9, R1..R9,
+// F1..F9, D1..D9, L1..L9, B1..B9); the centre stickers define the colours.
+// The cubie slots match that layout, but this solver's move table turns every
+// face the other way round: its "U" is a standard U'.
+static const int CORNER_FACELET[8][3] = {
+    {8, 9, 20}, {6, 18, 38}, {0, 36, 47}, {2, 45, 11},
+    {29, 26, 15}, {27, 44, 24}, {33, 53, 42}, {35, 17, 51}
+};
+static const int EDGE_FACELET[12][2] = {
+    {5, 10}, {7, 19}, {3, 37}, {1, 46}, {32, 16}, {28, 25},
+    {30, 43}, {34, 52}, {23, 12}, {21, 41}, {50, 39}, {48, 14}
+};
+static const char CORNER_COLOR[8][3] = {
+    {'U','R','F'}, {'U','F','L'}, {'U','L','B'}, {'U','B','R'},
+    {'D','F','R'}, {'D','L','F'}, {'D','B','L'}, {'D','R','B'}
+};
+static const char EDGE_COLOR[12][2] = {
+    {'U','R'}, {'U','F'}, {'U','L'}, {'U','B'}, {'D','R'}, {'D','F'},
+    {'D','L'}, {'D','B'}, {'F','R'}, {'F','L'}, {'B','L'}, {'B','R'}
+};
+
+int permutation_parity(const uint8_t *p, int n) {
+    int swaps = 0;
+    for(int i=0; i<n; i++) for(int j=i+1; j<n; j++) if(p[j] < p[i]) swaps++;
+    return swaps & 1;
+}
+
+bool parse_facelets(const string &text, CubieCube &c, string &error) {
+    if(text.size() != 54) {
+        error = "facelet string must have 54 characters";
+        return false;
+    }
+    // Map each sticker colour to the face whose centre carries it
+    map<char,char> face_of;
+    const char faces[6] = {'U','R','F','D','L','B'};
+    for(int f=0; f<6; f++) face_of[text[9*f + 4]] = faces[f];
+    if(face_of.size() != 6) {
+        error = "centre stickers must all differ";
+        return false;
+    }
+    string f(54, ' ');
+    for(int i=0; i<54; i++) {
+        auto it = face_of.find(text[i]);
+        if(it == face_of.end()) {
+            error = string("unknown colour '") + text[i] + "'";
+            return false;
+        }
+        f[i] = it->second;
+    }
+    
+    bool corner_seen[8] = {false}, edge_seen[12] = {false};
+    for(int i=0; i<8; i++) {
+        int ori = 0;
+        while(ori < 3 && f[CORNER_FACELET[i][ori]] != 'U' && f[CORNER_FACELET[i][ori]] != 'D') ori++;
+        int j = 8;
+        if(ori < 3) {
+            char c1 = f[CORNER_FACELET[i][(ori + 1) % 3]];
+            char c2 = f[CORNER_FACELET[i][(ori + 2) % 3]];
+            for(j=0; j<8; j++) {
+                if(CORNER_COLOR[j][1] == c1 && CORNER_COLOR[j][2] == c2) break;
+            }
+        }
+        if(j == 8 || corner_seen[j]) {
+            error = "invalid corner at slot " + to_string(i);
+            return false;
+        }
+        corner_seen[j] = true;
+        c.cp[i] = j;
+        c.co[i] = ori;
+    }
+    for(int i=0; i<12; i++) {
+        char a = f[EDGE_FACELET[i][0]], b = f[EDGE_FACELET[i][1]];
+        int j = 0;
+        for(; j<12; j++) {
+            if(EDGE_COLOR[j][0] == a && EDGE_COLOR[j][1] == b) { c.eo[i] = 0; break; }
+            if(EDGE_COLOR[j][0] == b && EDGE_COLOR[j][1] == a) { c.eo[i] = 1; break; }
+        }
+        if(j == 12 || edge_seen[j]) {
+            error = "invalid edge at slot " + to_string(i);
+            return false;
+        }
+        edge_seen[j] = true;
+        c.ep[i] = j;
+    }
+    
+    return check_solvable(c, error);
+}
+
+bool check_solvable(const CubieCube &c, string &error) {
+    int twist = 0, flip = 0;
+    for(int i=0; i<8; i++) twist += c.co[i];
+    for(int i=0; i<12; i++) flip += c.eo[i];
+    if(twist % 3 != 0) { error = "corner twist is not solvable"; return false; }
+    if(flip % 2 != 0) { error = "edge flip is not solvable"; return false; }
+    if(permutation_parity(c.cp.data(), 8) != permutation_parity(c.ep.data(), 12)) {
+        error = "corner and edge permutation parities differ";
+        return false;
+    }
+    return true;
+}
+
+// hi in 10 hex digits, then lo in 15: the 100 bits of the key, no padding
+string key_to_string(const CubeKey &k) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%010llx%015llx", (unsigned long long)k.hi, (unsigned long long)k.lo);
+    return buf;
+}
+
+bool parse_key(const string &text, CubieCube &c, string &error) {
+    if(text.size() != KEY_DIGITS || text.find_first_not_of("0123456789abcdef") != string::npos) {
+        error = "state key must be " + to_string(KEY_DIGITS) + " lowercase hex digits";
+        return false;
+    }
+    CubeKey k;
+    k.hi = stoull(text.substr(0, 10), nullptr, 16);
+    k.lo = stoull(text.substr(10), nullptr, 16);
+    c = key_cube(k);
+    bool corner_seen[8] = {false}, edge_seen[12] = {false};
+    for(int i=0; i<8; i++) {
+        if(corner_seen[c.cp[i]] || c.co[i] > 2) {
+            error = "invalid corner at slot " + to_string(i);
+            return false;
+        }
+        corner_seen[c.cp[i]] = true;
+    }
+    for(int i=0; i<12; i++) {
+        if(c.ep[i] > 11 || edge_seen[c.ep[i]]) {
+            error = "invalid edge at slot " + to_string(i);
+            return false;
+        }
+        edge_seen[c.ep[i]] = true;
+    }
+    return check_solvable(c, error);
+}
+
+// One position per line, as in batch input: a move sequence in this solver's
+// notation applied to the solved cube, a 54-character facelet string, or a
+// state key as printed by key_to_string
+bool parse_position(const string &line, CubieCube &c, bool &facelets, string &error) {
+    c = CubieCube::solved();
+    facelets = line.size() == 54 && line.find(' ') == string::npos;
+    if(facelets) return parse_facelets(line, c, error);
+    if(line.size() == KEY_DIGITS && line.find_first_not_of("0123456789abcdef") == string::npos)
+        return parse_key(line, c, error);
+    vector<int> seq;
+    if(!parse_moves(line, seq, error)) return false;
+    for(int m : seq) c = apply_move(c, m);
+    return true;
+}
+
+// ============================================================================
+// SCRAMBLES AND RANDOM STATES
+// ============================================================================
+
+// rng() % n rather than the std distributions and std::shuffle, whose output
+// differs between standard libraries: a seed names the same corpus everywhere
+vector<int> scramble_cube(CubieCube &c, int num_moves, unsigned seed) {
+    vector<int> seq;
+    mt19937 rng(seed);
+    
+    for(int i=0; i<num_moves; i++) {
+        int m = rng() % 18;
+        c = apply_move(c, m);
+        seq.push_back(m);
+    }
+    return seq;
+}
+
+// Uniform over the reachable states: any corner and edge permutations of
+// equal parity, any twists and flips with the last one fixed by the others
+CubieCube random_cube(mt19937 &rng) {
+    CubieCube c;
+    for(int i=7; i>0; i--) swap(c.cp[i], c.cp[rng() % (i + 1)]);
+    for(int i=11; i>0; i--) swap(c.ep[i], c.ep[rng() % (i + 1)]);
+    if(permutation_parity(c.cp.data(), 8) != permutation_parity(c.ep.data(), 12)) swap(c.ep[0], c.ep[1]);
+    int twist = 0, flip = 0;
+    for(int i=0; i<7; i++) { c.co[i] = rng() % 3; twist += c.co[i]; }
+    for(int i=0; i<11; i++) { c.eo[i] = rng() % 2; flip += c.eo[i]; }
+    c.co[7] = (3 - twist % 3) % 3;
+    c.eo[11] = flip % 2;
+    return c;
+}
@@ -0,0 +1,48 @@
+// core/notation.h
+// Getting positions in and out as text: move sequences, 54-character facelet
+// strings, state keys, seeded scrambles and uniformly random states. Shared by
+// the solver CLI and the benchmark so both read the same corpus files.
+
+#pragma once
+
+#include "cube.h"
+
+// ============================================================================
+// MOVE AND FACELET PARSING
+// ============================================================================
+
+string seq_to_string(const vector<int> &seq);
+
+// Whitespace-separated move names as printed by seq_to_string
+bool parse_moves(const string &text, vector<int> &seq, string &error);
+
+// Standard URFDLB facelet string; rejects unsolvable cubes
+bool parse_facelets(const string &text, CubieCube &c, string &error);
+
+// Twist, flip and permutation parity of an otherwise well-formed cube
+bool check_solvable(const CubieCube &c, string &error);
+
+// A CubeKey as 25 lowercase hex digits, and back; rejects unsolvable cubes
+const size_t KEY_DIGITS = 25;
+string key_to_string(const CubeKey &k);
+bool parse_key(const string &text, CubieCube &c, string &error);
+
+// Moves, facelets or a state key, whichever the line is; facelets reports
+// whether it was facelets (solutions are then printed in standard notation)
+bool parse_position(const string &line, CubieCube &c, bool &facelets, string &error);
+
+int permutation_parity(const uint8_t *p, int n);
+
+// Same face turned the opposite way, i.e. this solver's move in standard notation
+inline int reverse_turn(int m) {
+    if(m < 6) return m + 6;
+    if(m < 12) return m - 6;
+    return m;
+}
+
+// ============================================================================
+// SCRAMBLES AND RANDOM STATES
+// ============================================================================
+
+vector<int> scramble_cube(CubieCube &c, int num_moves, unsigned seed);
+CubieCube random_cube(mt19937 &rng);
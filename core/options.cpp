@@ -0,0 +1,49 @@
+// core/options.cpp
+// Shared command-line options; see options.h.
+
+#include "options.h"
+
+bool parse_solver_option(int argc, char **argv, int &i, SolverOptions &opt) {
+    string arg = argv[i];
+    bool value = i+1 < argc;
+    if(arg == "--mode" && value) {
+        string mode = argv[++i];
+        opt.two_phase = mode == "two-phase";
+        opt.mitm = mode == "mitm";
+    } else if(arg == "--target" && value) {
+        opt.two_phase_opt.target = stoi(argv[++i]);
+    } else if(arg == "--time-budget" && value) {
+        opt.two_phase_opt.time_budget = stod(argv[++i]);
+    } else if(arg == "--mitm-depth" && value) {
+        opt.mitm_opt.depth = max(0, stoi(argv[++i]));
+    } else if(arg == "--mitm-mb" && value) {
+        opt.mitm_opt.megabytes = max(0, stoi(argv[++i]));
+    } else if(arg == "--threads" && value) {
+        opt.par.threads = max(1, stoi(argv[++i]));
+    } else if(arg == "--split-depth" && value) {
+        opt.par.split_depth = max(1, stoi(argv[++i]));
+    } else if(arg == "--deterministic") {
+        opt.par.deterministic = true;
+    } else if(arg == "--tt-mb" && value) {
+        tt_megabytes = max(0, stoi(argv[++i]));
+    } else if(arg == "--no-sym-lookups") {
+        sym_lookups = false;
+    } else if(arg == "--bpmx") {
+        use_bpmx = true;
+    } else if(arg == "--dual" && value) {
+        string mode = argv[++i];
+        dual_mode = mode == "eager" ? DUAL_EAGER : mode == "lazy" ? DUAL_LAZY : DUAL_OFF;
+    } else if(arg == "--pdb-populate") {
+        pdb_options.populate = true;
+    } else if(arg == "--pdb-pages" && value) {
+        string pages = argv[++i];
+        pdb_options.pages = pages == "hugetlb" ? PAGES_HUGETLB : pages == "thp" ? PAGES_THP : PAGES_SHARED;
+    } else if(arg == "--pdb-numa") {
+        pdb_options.numa = true;
+    } else if(arg == "--verify-pdbs") {
+        pdb_options.verify = true;
+    } else {
+        return false;
+    }
+    return true;
+}
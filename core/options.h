@@ -0,0 +1,21 @@
+// core/options.h
+// Command-line options that rubiks_solver and bench share: search mode,
+// parallel search, heuristic and PDB placement. Each tool parses its own
+// options first and hands the rest to parse_solver_option.
+
+#pragma once
+
+#include "search.h"
+
+struct SolverOptions {
+    bool two_phase = false;       // --mode two-phase
+    TwoPhaseOptions two_phase_opt;
+    bool mitm = false;            // --mode mitm
+    MitmOptions mitm_opt;
+    ParallelOptions par;
+};
+
+// Parses argv[i], and its value if it takes one (advancing i), into opt or
+// into the heuristic and PDB globals it sets. False, with i unchanged, if it
+// is not a shared option.
+bool parse_solver_option(int argc, char **argv, int &i, SolverOptions &opt);
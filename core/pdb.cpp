@@ -0,0 +1,655 @@
+// core/pdb.cpp
+// PDB file I/O, loading and the PDB heuristic; see pdb.h.
+
+#include "pdb.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+
+// ============================================================================
+// PDB FILE FORMAT
+// ============================================================================
+
+uint64_t pdb_checksum(const uint8_t *data, size_t size) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    size_t i = 0;
+    for(; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        h = (h ^ word) * 0x100000001b3ULL;
+    }
+    for(; i < size; i++) h = (h ^ data[i]) * 0x100000001b3ULL;
+    return h;
+}
+
+bool write_pdb(const string &filename, PdbScheme scheme, int entry_bits,
+               long long states, const vector<uint8_t> &pdb, int max_depth) {
+    if(max_depth < 0) {
+        int unseen = entry_bits == 4 ? 0xF : 0xFF;
+        max_depth = 0;
+        for(long long i=0; i<states; i++) {
+            int v = entry_bits == 4 ? (pdb[i >> 1] >> ((i & 1) << 2)) & 0xF : pdb[i];
+            if(v != unseen) max_depth = max(max_depth, v);
+        }
+    }
+    
+    PdbHeader hdr = {};
+    memcpy(hdr.magic, PDB_MAGIC, sizeof(PDB_MAGIC));
+    hdr.version = PDB_VERSION;
+    hdr.scheme = scheme;
+    hdr.entry_bits = entry_bits;
+    hdr.max_depth = max_depth;
+    hdr.states = states;
+    hdr.data_bytes = pdb.size();
+    hdr.checksum = pdb_checksum(pdb.data(), pdb.size());
+    
+    ofstream out(filename, ios::binary);
+    out.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    out.write(reinterpret_cast<const char*>(pdb.data()), pdb.size());
+    out.close();
+    if(!out) {
+        *log_out << "Error: could not write " << filename << "\n";
+        return false;
+    }
+    return true;
+}
+
+vector<uint8_t> pack_mod3(const vector<uint8_t> &depths) {
+    vector<uint8_t> packed((depths.size() + 3) / 4, 0);
+    for(size_t i=0; i<depths.size(); i++) {
+        int v = depths[i] == 255 ? 3 : depths[i] % 3;
+        packed[i >> 2] |= v << ((i & 3) << 1);
+    }
+    return packed;
+}
+
+// ============================================================================
+// PDB LOADING
+// ============================================================================
+
+PdbLoadOptions pdb_options;
+ostream *log_out = &cout;
+
+void PdbData::reset() {
+#ifndef _WIN32
+    if(map_base) munmap(map_base, map_len);
+    for(auto &copy : copies) munmap(copy.first, copy.second);
+#endif
+    map_base = nullptr;
+    map_len = 0;
+    copies.clear();
+    owned.clear();
+    owned.shrink_to_fit();
+    data = nullptr;
+    node_data.fill(nullptr);
+    bytes = 0;
+    max_value = 0;
+}
+
+// ============================================================================
+// PDB PLACEMENT
+// ============================================================================
+// Private copies for PAGES_THP, PAGES_HUGETLB and --pdb-numa, made right
+// after a table is read and replacing the file mapping. The copy is filled
+// after mbind, so its pages are faulted in on the node it belongs to.
+
+thread_local int pdb_node = 0;
+static int pdb_nodes = 1;      // NUMA nodes that get a copy
+
+const size_t HUGE_PAGE = 2 << 20;
+
+#ifdef __linux__
+// Highest node in /sys/devices/system/node/online ("0", "0-1", "0,2") + 1
+static int online_numa_nodes() {
+    ifstream in("/sys/devices/system/node/online");
+    string list;
+    if(!(in >> list)) return 1;
+    size_t sep = list.find_last_of("-,");
+    int nodes = atoi(list.c_str() + (sep == string::npos ? 0 : sep + 1)) + 1;
+    return min(max(nodes, 1), PDB_MAX_NODES);
+}
+
+// Bytes of the mapping that holds addr that sit on huge pages: THP, file
+// pages in PMD-sized folios (ext4 and tmpfs can map PDB files that way on
+// their own) and hugetlbfs
+static size_t huge_mapped_bytes(const void *addr) {
+    static const char *fields[] = {"AnonHugePages:", "FilePmdMapped:", "Private_Hugetlb:", "Shared_Hugetlb:"};
+    ifstream in("/proc/self/smaps");
+    string line;
+    bool inside = false;
+    size_t kb = 0;
+    while(getline(in, line)) {
+        unsigned long lo, hi;
+        if(sscanf(line.c_str(), "%lx-%lx ", &lo, &hi) == 2) {
+            if(inside) break;
+            inside = lo <= (uintptr_t)addr && (uintptr_t)addr < hi;
+            continue;
+        }
+        for(const char *f : fields) {
+            size_t n = strlen(f);
+            if(inside && line.compare(0, n, f) == 0) kb += strtoull(line.c_str() + n, nullptr, 10);
+        }
+    }
+    return kb * 1024;
+}
+
+// Read-only copy of src in fresh anonymous memory, on huge pages if the
+// options ask for them and on node (or anywhere, for -1). Sets len to the
+// mapping length, and hugetlb if the pages came from the hugetlbfs pool.
+static void *private_copy(const uint8_t *src, size_t bytes, int node, size_t &len, bool &hugetlb) {
+    len = (bytes + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE;
+    hugetlb = false;
+    void *p = MAP_FAILED;
+    if(pdb_options.pages == PAGES_HUGETLB) {
+        p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        hugetlb = p != MAP_FAILED;
+    }
+    if(p == MAP_FAILED) {
+        // One extra huge page of slack, so the copy can start on a 2 MB
+        // boundary and every 2 MB of it can be a huge page
+        void *raw = mmap(nullptr, len + HUGE_PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(raw == MAP_FAILED) return nullptr;
+        uintptr_t start = ((uintptr_t)raw + HUGE_PAGE - 1) & ~(uintptr_t)(HUGE_PAGE - 1);
+        size_t head = start - (uintptr_t)raw;
+        if(head) munmap(raw, head);
+        munmap((char *)start + len, HUGE_PAGE - head);
+        p = (void *)start;
+        if(pdb_options.pages != PAGES_SHARED) madvise(p, len, MADV_HUGEPAGE);
+    }
+    if(node >= 0) {
+        unsigned long mask = 1UL << node;
+        syscall(SYS_mbind, p, len, MPOL_BIND, &mask, sizeof(mask) * 8, 0);
+    }
+    memcpy(p, src, bytes);
+    mprotect(p, len, PROT_READ);
+    return p;
+}
+#endif
+
+size_t pdb_huge_bytes(const PdbData &pdb) {
+    size_t huge = 0;
+#ifdef __linux__
+    if(pdb.map_base) huge += min(pdb.bytes, huge_mapped_bytes(pdb.map_base));
+    for(auto &copy : pdb.copies) huge += min(pdb.bytes, huge_mapped_bytes(copy.first));
+#else
+    (void)pdb;
+#endif
+    return huge;
+}
+
+void pdb_bind_thread() {
+    pdb_node = 0;
+#ifdef __linux__
+    unsigned cpu = 0, node = 0;
+    if(pdb_nodes > 1 && syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 && (int)node < pdb_nodes) {
+        pdb_node = node;
+    }
+#endif
+}
+
+static void place_pdb(PdbData &pdb) {
+    pdb.node_data.fill(pdb.data);
+    if(pdb_options.pages == PAGES_SHARED && !pdb_options.numa) return;
+#ifdef __linux__
+    for(int n=0; n<pdb_nodes; n++) {
+        size_t len;
+        bool hugetlb;
+        void *p = private_copy(pdb.data, pdb.bytes, pdb_options.numa ? n : -1, len, hugetlb);
+        if(!p) break;
+        static bool warned = false;
+        if(pdb_options.pages == PAGES_HUGETLB && !hugetlb && !warned) {
+            *log_out << "Warning: hugetlbfs pool too small (vm.nr_hugepages), using transparent huge pages\n";
+            warned = true;
+        }
+        pdb.copies.push_back({p, len});
+    }
+    if(pdb.copies.empty()) {
+        *log_out << "Warning: No memory for a private copy, reading the table in place\n";
+        return;
+    }
+    if(pdb.map_base) munmap(pdb.map_base, pdb.map_len);
+    pdb.map_base = nullptr;
+    pdb.map_len = 0;
+    pdb.owned.clear();
+    pdb.owned.shrink_to_fit();
+    pdb.data = static_cast<const uint8_t *>(pdb.copies[0].first);
+    // A node whose copy failed reads node 0's
+    for(int n=0; n<PDB_MAX_NODES; n++) {
+        pdb.node_data[n] = static_cast<const uint8_t *>(pdb.copies[n < (int)pdb.copies.size() ? n : 0].first);
+    }
+#else
+    *log_out << "Warning: Huge-page and NUMA placement need Linux, reading the table in place\n";
+#endif
+}
+
+// ", 2 MB pages" and the like for the load message. Empty for a file
+// mapping, whose pages are not faulted in yet.
+static string placement_note(const PdbData &pdb) {
+    if(pdb.copies.empty()) return "";
+    ostringstream out;
+    size_t mapped = pdb.bytes * pdb.copies.size(), huge = pdb_huge_bytes(pdb);
+    if(huge == mapped) {
+        out << ", 2 MB pages";
+    } else if(huge > 0) {
+        out << ", 2 MB pages for " << huge / 1048576.0 << " of " << mapped / 1048576.0 << " MB";
+    } else {
+        out << ", 4 KB pages";
+    }
+    if(pdb.copies.size() > 1) out << ", " << pdb.copies.size() << " NUMA copies";
+    return out.str();
+}
+
+PdbData pdb_corners;
+bool pdb_corners_sym = false;
+bool pdb_corners_mod3 = false;
+PdbData pdb_edges_a;
+PdbData pdb_edges_b;
+EdgePdb pdb_korf_a;
+EdgePdb pdb_korf_b;
+
+bool sym_lookups = true;
+DualMode dual_mode = DUAL_OFF;
+
+array<int,6> subset_a = {0, 1, 2, 3, 4, 5};
+array<int,6> subset_b = {6, 7, 8, 9, 10, 11};
+
+bool load_pdb(const string &filename, PdbData &pdb, long long states,
+              PdbScheme scheme, int entry_bits) {
+    pdb.reset();
+    long long expected_size = (states * entry_bits + 7) / 8;
+    ifstream in(filename, ios::binary | ios::ate);
+    if(!in) {
+        *log_out << "Warning: Could not load " << filename << "\n";
+        return false;
+    }
+    long long file_size = in.tellg();
+    in.seekg(0);
+    
+    PdbHeader hdr;
+    bool versioned = file_size >= (long long)sizeof(hdr)
+        && in.read(reinterpret_cast<char*>(&hdr), sizeof(hdr))
+        && memcmp(hdr.magic, PDB_MAGIC, sizeof(PDB_MAGIC)) == 0;
+    
+    if(!versioned) {
+        if(entry_bits == 2) {
+            *log_out << "Warning: " << filename << " has no PDB header\n";
+            return false;
+        }
+        if(file_size != expected_size) {
+            *log_out << "Warning: " << filename << " is " << file_size << " bytes, expected "
+                 << expected_size << "\n";
+            return false;
+        }
+        pdb.owned.resize(expected_size);
+        in.seekg(0);
+        if(!in.read(reinterpret_cast<char*>(pdb.owned.data()), expected_size)) {
+            *log_out << "Warning: Short read from " << filename << "\n";
+            pdb.reset();
+            return false;
+        }
+        pdb.data = pdb.owned.data();
+        pdb.bytes = expected_size;
+        // No header to say, so find the largest entry that is not the unseen marker
+        for(uint8_t b : pdb.owned) {
+            if(entry_bits == 8) {
+                if(b != 255) pdb.max_value = max(pdb.max_value, (int)b);
+            } else {
+                if((b & 0xF) != 0xF) pdb.max_value = max(pdb.max_value, b & 0xF);
+                if((b >> 4) != 0xF) pdb.max_value = max(pdb.max_value, b >> 4);
+            }
+        }
+        place_pdb(pdb);
+        *log_out << "[OK] Loaded " << filename << " (" << (expected_size / 1024.0) << " KB, raw"
+                 << placement_note(pdb) << ")\n";
+        return true;
+    }
+    
+    if(hdr.version != PDB_VERSION || hdr.scheme != scheme || (int)hdr.entry_bits != entry_bits
+       || (long long)hdr.states != states || (long long)hdr.data_bytes != expected_size
+       || file_size != (long long)(sizeof(hdr) + hdr.data_bytes)) {
+        *log_out << "Warning: " << filename << " header does not match (version " << hdr.version
+             << ", scheme " << hdr.scheme << ", " << hdr.entry_bits << "-bit, "
+             << hdr.states << " states, " << hdr.data_bytes << " bytes)\n";
+        return false;
+    }
+    
+#ifndef _WIN32
+    int fd = open(filename.c_str(), O_RDONLY);
+    if(fd >= 0) {
+        int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+        if(pdb_options.populate) flags |= MAP_POPULATE;
+#endif
+        void *base = mmap(nullptr, file_size, PROT_READ, flags, fd, 0);
+        close(fd);
+        if(base != MAP_FAILED) {
+            // Lookups are scattered; don't let readahead pull in neighbouring pages
+            madvise(base, file_size, pdb_options.populate ? MADV_WILLNEED : MADV_RANDOM);
+            pdb.map_base = base;
+            pdb.map_len = file_size;
+            pdb.data = static_cast<const uint8_t*>(base) + sizeof(hdr);
+            pdb.bytes = hdr.data_bytes;
+        }
+    }
+#endif
+    if(!pdb.data) {
+        pdb.owned.resize(hdr.data_bytes);
+        if(!in.read(reinterpret_cast<char*>(pdb.owned.data()), hdr.data_bytes)) {
+            *log_out << "Warning: Short read from " << filename << "\n";
+            pdb.reset();
+            return false;
+        }
+        pdb.data = pdb.owned.data();
+        pdb.bytes = hdr.data_bytes;
+    }
+    
+    if(pdb_options.verify && pdb_checksum(pdb.data, pdb.bytes) != hdr.checksum) {
+        *log_out << "Warning: " << filename << " checksum mismatch\n";
+        pdb.reset();
+        return false;
+    }
+    
+    pdb.max_value = hdr.max_depth;
+    bool mapped = pdb.map_base;
+    place_pdb(pdb);
+    *log_out << "[OK] " << (mapped && pdb.copies.empty() ? "Mapped " : "Loaded ") << filename << " ("
+         << (pdb.bytes / 1024.0) << " KB, max depth " << hdr.max_depth << placement_note(pdb) << ")\n";
+    return true;
+}
+
+// Prefer the 7-edge table, fall back to the 6-edge one when the 7-edge file
+// is missing or fails to load; both are optional
+void load_korf_edge_pdb(EdgePdb &pdb, const char *name7, int first7, PdbScheme scheme7,
+                        const char *name6, int first6, PdbScheme scheme6) {
+    if(ifstream(name7).good()) {
+        pdb.edges = 7; pdb.first = first7;
+        if(load_pdb(name7, pdb.data, korf_edge_states(7), scheme7, 4)) return;
+    }
+    if(ifstream(name6).good()) {
+        pdb.edges = 6; pdb.first = first6;
+        if(load_pdb(name6, pdb.data, korf_edge_states(6), scheme6, 4)) return;
+    }
+    pdb.data.reset();
+    pdb.edges = 0;
+}
+
+void load_pdbs() {
+    *log_out << "Loading Pattern Databases...\n";
+#ifdef __linux__
+    pdb_nodes = pdb_options.numa ? online_numa_nodes() : 1;
+    if(pdb_options.numa) *log_out << "[INFO] " << pdb_nodes << " NUMA node(s), one table copy each\n";
+#endif
+    // Same values from all four; the reduced table is 6 MB instead of 84 MB,
+    // and the 2-bit ones are a quarter of that (1.4 MB and 21 MB)
+    struct CornerFile { const char *name; PdbScheme scheme; bool sym; int bits; };
+    const CornerFile corner_files[] = {
+        {"pdbs/corners_sym_mod3.bin", SCHEME_CORNERS_SYM, true, 2},
+        {"pdbs/corners_sym.bin", SCHEME_CORNERS_SYM, true, 8},
+        {"pdbs/corners_mod3.bin", SCHEME_CORNERS, false, 2},
+        {"pdbs/corners.bin", SCHEME_CORNERS, false, 8},
+    };
+    bool corners_loaded = false;
+    pdb_corners_sym = false;
+    pdb_corners_mod3 = false;
+    for(const CornerFile &f : corner_files) {
+        // Only corners.bin, which may be a raw file, is tried when missing, for the warning
+        if(f.bits == 2 || f.sym) {
+            if(!ifstream(f.name).good()) continue;
+        }
+        long long states = f.sym ? (long long)N_CPERM_CLASS * N_CORI : 88179840;
+        if(load_pdb(f.name, pdb_corners, states, f.scheme, f.bits)) {
+            corners_loaded = true;
+            pdb_corners_sym = f.sym;
+            pdb_corners_mod3 = f.bits == 2;
+            break;
+        }
+    }
+    load_korf_edge_pdb(pdb_korf_a, "pdbs/edges7_a.bin", 0, SCHEME_EDGES7_A,
+                       "pdbs/edges6_a.bin", 0, SCHEME_EDGES6_A);
+    load_korf_edge_pdb(pdb_korf_b, "pdbs/edges7_b.bin", 5, SCHEME_EDGES7_B,
+                       "pdbs/edges6_b.bin", 6, SCHEME_EDGES6_B);
+    // The legacy tables were filled by a BFS that keeps one cube per index,
+    // but cubes sharing an index can be at different distances, so some
+    // entries overestimate. They stand in only when there is no Korf table.
+    pdb_edges_a.reset();
+    pdb_edges_b.reset();
+    if(pdb_korf_a.data.empty() && pdb_korf_b.data.empty()) {
+        load_pdb("pdbs/edges_a.bin", pdb_edges_a, 23040, SCHEME_EDGES_A, 8);
+        load_pdb("pdbs/edges_b.bin", pdb_edges_b, 23040, SCHEME_EDGES_B, 8);
+        if(!pdb_edges_a.empty() || !pdb_edges_b.empty()) {
+            *log_out << "Warning: edges_a/edges_b can overestimate, so solutions may not be optimal;"
+                     << " generate edges6_a and edges6_b\n";
+        }
+    }
+    build_heuristic_terms();
+    if(corners_loaded) {
+        *log_out << "[OK] All PDBs loaded successfully\n";
+    } else if(heuristic_terms[0].source == H_FALLBACK) {
+        *log_out << "[INFO] No PDBs found, running with the misplaced-piece bound only\n";
+    } else {
+        *log_out << "[INFO] Running with edge PDBs only\n";
+    }
+}
+
+// ============================================================================
+// PDB HEURISTIC
+// ============================================================================
+
+const char *h_source_names[H_SOURCES] = {
+    "none", "corners", "korf_a", "korf_b", "edges_a", "edges_b", "korf_a_sym", "korf_b_sym",
+    "korf_a_dual", "korf_b_dual", "fallback"};
+
+vector<HeuristicTerm> heuristic_terms;
+
+// Corners first: they supply the max for most nodes, and once h passes the
+// cutoff nothing after them is looked up
+void build_heuristic_terms() {
+    heuristic_terms.clear();
+    bool eager = dual_mode == DUAL_EAGER;
+    if(!pdb_corners.empty()) heuristic_terms.push_back({H_CORNERS, pdb_corners.max_value, nullptr, 0, false});
+    for(const EdgePdb *pdb : {&pdb_korf_a, &pdb_korf_b}) {
+        if(pdb->data.empty()) continue;
+        heuristic_terms.push_back({pdb == &pdb_korf_a ? H_KORF_A : H_KORF_B, pdb->data.max_value, pdb, 0, false});
+    }
+    if(!pdb_edges_a.empty()) heuristic_terms.push_back({H_EDGES_A, pdb_edges_a.max_value, nullptr, 0, false});
+    if(!pdb_edges_b.empty()) heuristic_terms.push_back({H_EDGES_B, pdb_edges_b.max_value, nullptr, 0, false});
+    // The same Korf tables seen from the R/L and F/B axes
+    for(const EdgePdb *pdb : {&pdb_korf_a, &pdb_korf_b}) {
+        if(pdb->data.empty() || !sym_lookups) continue;
+        for(int s : {SYM_URF3, 2 * SYM_URF3}) {
+            heuristic_terms.push_back({pdb == &pdb_korf_a ? H_KORF_A_SYM : H_KORF_B_SYM,
+                                       pdb->data.max_value, pdb, s, false});
+        }
+    }
+    // The inverse cube, from each axis the primary lookups use. Only the edge
+    // tables: the corner table holds exact distances in the corner group,
+    // where X and X^-1 are equally far, and the legacy tables overestimate.
+    for(const EdgePdb *pdb : {&pdb_korf_a, &pdb_korf_b}) {
+        if(pdb->data.empty() || dual_mode == DUAL_OFF) continue;
+        for(int s : {0, SYM_URF3, 2 * SYM_URF3}) {
+            if(s && !sym_lookups) continue;
+            heuristic_terms.push_back({pdb == &pdb_korf_a ? H_KORF_A_DUAL : H_KORF_B_DUAL,
+                                       pdb->data.max_value, pdb, s, eager});
+        }
+    }
+    if(heuristic_terms.empty()) heuristic_terms.push_back({H_FALLBACK, 20, nullptr, 0, false});
+}
+
+// Without tables: a turn moves four corners and four edges, so a quarter of
+// the misplaced pieces of either kind is still a lower bound
+int misplaced_bound(const CoordCube &c) {
+    CubieCube cube = from_coord(c);
+    int corners = 0, edges = 0;
+    for(int i=0; i<8; i++) if(cube.cp[i] != i || cube.co[i] != 0) corners++;
+    for(int i=0; i<12; i++) if(cube.ep[i] != i || cube.eo[i] != 0) edges++;
+    return (max(corners, edges) + 3) / 4;
+}
+
+// max() that remembers which table raised h
+inline void raise_h(int &h, int &which, int value, int from) {
+    if(value > h) {
+        h = value;
+        which = from;
+    }
+}
+
+inline void decode_edge_cubies(const CoordCube &c, uint8_t *pos, uint8_t *ori) {
+    for(int k=0; k<4; k++) {
+        const Edge3Cubies &d = edge3_decode[c.edge3[k]];
+        for(int j=0; j<3; j++) {
+            pos[3*k + j] = d.pos[j];
+            ori[3*k + j] = d.ori[j];
+        }
+    }
+}
+
+inline long long corner_index(int cperm, int cori) {
+    if(!pdb_corners_sym) return (long long)cperm * N_CORI + cori;
+    return (long long)cperm_class[cperm] * N_CORI + cori_conj[cori][cperm_sym[cperm]];
+}
+
+int corner_distance(const CoordCube &c) {
+    if(!pdb_corners_mod3) return pdb_corners[corner_index(c.cperm, c.cori)];
+    int cp = c.cperm, co = c.cori, depth = 0;
+    int residue = pdb_mod3(pdb_corners, corner_index(cp, co));
+    while(cp != coord_solved.cperm || co != coord_solved.cori) {
+        int lower = (residue + 2) % 3;
+        int m = 0;
+        while(m < 18 && pdb_mod3(pdb_corners, corner_index(cperm_move[cp][m], cori_move[co][m])) != lower) m++;
+        if(m == 18) return 0;   // not a distance table; 0 is still a lower bound
+        cp = cperm_move[cp][m];
+        co = cori_move[co][m];
+        residue = lower;
+        depth++;
+    }
+    return depth;
+}
+
+// Korf index of the cube whose edge cubie i sits in slot pos[i] with flip
+// ori[i], conjugated by sym
+inline long long conj_korf_index(const EdgePdb &pdb, const uint8_t *pos, const uint8_t *ori, int sym) {
+    if(!sym) return encode_edge_korf(pos + pdb.first, ori + pdb.first, pdb.edges);
+    const EdgeConj &e = edge_conj[sym];
+    uint8_t cpos[12], cori[12];
+    for(int j=0; j<pdb.edges; j++) {
+        int k = pdb.first + j, src = e.src[k];
+        cpos[j] = e.slot[pos[src]];
+        cori[j] = ori[src] ^ e.flip[k][pos[src]];
+    }
+    return encode_edge_korf(cpos, cori, pdb.edges);
+}
+
+long long korf_index(const CoordCube &c, const EdgePdb &pdb, int sym) {
+    uint8_t pos[12], ori[12];
+    decode_edge_cubies(c, pos, ori);
+    return conj_korf_index(pdb, pos, ori, sym);
+}
+
+long long korf_dual_index(const CoordCube &c, const EdgePdb &pdb, int sym) {
+    uint8_t pos[12], ori[12], ep[12], eo[12];
+    decode_edge_cubies(c, pos, ori);
+    for(int i=0; i<12; i++) {
+        ep[pos[i]] = i;
+        eo[pos[i]] = ori[i];
+    }
+    return conj_korf_index(pdb, ep, eo, sym);
+}
+
+void heuristic_prefetch(const CoordCube &c, HeuristicProbe &probe) {
+    if(!pdb_corners.empty()) {
+        probe.corner = corner_index(c.cperm, c.cori);
+        pdb_corners.prefetch(pdb_corners_mod3 ? probe.corner >> 2 : probe.corner);
+    }
+    decode_edge_cubies(c, probe.pos, probe.ori);
+    for(int k=0; k<2; k++) {
+        const EdgePdb &pdb = k ? pdb_korf_b : pdb_korf_a;
+        if(pdb.data.empty()) continue;
+        probe.korf[k] = encode_edge_korf(probe.pos + pdb.first, probe.ori + pdb.first, pdb.edges);
+        pdb.data.prefetch(probe.korf[k] >> 1);
+    }
+}
+
+int heuristic_pdb(const CoordCube &c, int cutoff, int *source, HeuristicProbe *probe) {
+    int h = 0;
+    int which = H_NONE;
+    
+    // Slot and flip of every edge cubie, decoded on the first edge lookup
+    // (or taken from the probe), and the cubie and flip in every slot, on
+    // the first lookup that needs them
+    uint8_t edge_pos[12], edge_ori[12];
+    const uint8_t *pos = probe ? probe->pos : edge_pos, *ori = probe ? probe->ori : edge_ori;
+    array<uint8_t,12> ep, eo;
+    bool decoded = probe, slots = false;
+    auto decode_edges = [&]() {
+        decode_edge_cubies(c, edge_pos, edge_ori);
+        decoded = true;
+    };
+    auto decode_slots = [&]() {
+        for(int i=0; i<12; i++) {
+            ep[pos[i]] = i;
+            eo[pos[i]] = ori[i];
+        }
+        slots = true;
+    };
+    
+    for(const HeuristicTerm &t : heuristic_terms) {
+        if(h > cutoff && !t.eager) break;
+        if(h >= t.max_value) continue;
+        bool edge_term = t.source != H_CORNERS && t.source != H_FALLBACK;
+        if(edge_term && !decoded) decode_edges();
+        
+        int value = 0;
+        switch(t.source) {
+        case H_CORNERS:
+            if(!probe) {
+                value = corner_distance(c);
+            } else if(pdb_corners_mod3 && probe->corner_parent >= 0) {
+                value = mod3_child_depth(probe->corner_parent, pdb_mod3(pdb_corners, probe->corner));
+            } else {
+                value = pdb_corners_mod3 ? corner_distance(c) : pdb_corners[probe->corner];
+            }
+            if(probe) probe->corner_depth = value;
+            break;
+        case H_KORF_A:
+        case H_KORF_B:
+            value = pdb_nibble(t.korf->data, probe ? probe->korf[t.source == H_KORF_B]
+                               : encode_edge_korf(pos + t.korf->first, ori + t.korf->first, t.korf->edges));
+            break;
+        case H_KORF_A_SYM:
+        case H_KORF_B_SYM:
+            value = pdb_nibble(t.korf->data, conj_korf_index(*t.korf, pos, ori, t.sym));
+            break;
+        case H_KORF_A_DUAL:
+        case H_KORF_B_DUAL:
+            // The slot contents are the inverse cube's cubie positions
+            if(!slots) decode_slots();
+            value = pdb_nibble(t.korf->data, conj_korf_index(*t.korf, ep.data(), eo.data(), t.sym));
+            break;
+        case H_EDGES_A:
+        case H_EDGES_B: {
+            // Indexed by slot contents
+            if(!slots) decode_slots();
+            bool a = t.source == H_EDGES_A;
+            int idx = encode_edge_subset(ep, eo, a ? subset_a : subset_b);
+            value = (a ? pdb_edges_a : pdb_edges_b)[idx];
+            if(value == 255) value = 0;   // never reached by the generator
+            break;
+        }
+        case H_FALLBACK:
+            value = misplaced_bound(c);
+            break;
+        default:
+            break;
+        }
+        raise_h(h, which, value, t.source);
+    }
+    
+    if(source) *source = which;
+    return h;
+}
@@ -0,0 +1,232 @@
+// core/pdb.h
+// Pattern database files: the versioned on-disk format that gen_pdb writes,
+// the loader the solver maps them with, and the heuristic built on them.
+
+#pragma once
+
+#include "coord.h"
+
+// ============================================================================
+// PDB FILE FORMAT
+// ============================================================================
+// Versioned PDB file: a 64-byte header followed by the table. Files with this
+// header are mmap'd read-only so every solver process on a host shares one
+// page-cache copy; headerless .bin files from older gen_pdb builds are still
+// read into memory.
+
+const char PDB_MAGIC[8] = {'R','U','B','I','K','P','D','B'};
+const uint32_t PDB_VERSION = 1;
+
+enum PdbScheme : uint32_t {
+    SCHEME_CORNERS = 1,     // cperm * 2187 + cori
+    SCHEME_EDGES_A = 2,     // legacy 6-slot subset, slots 0-5
+    SCHEME_EDGES_B = 3,     // legacy 6-slot subset, slots 6-11
+    SCHEME_EDGES6_A = 4,    // Korf, edge cubies 0-5
+    SCHEME_EDGES6_B = 5,    // Korf, edge cubies 6-11
+    SCHEME_EDGES7_A = 6,    // Korf, edge cubies 0-6
+    SCHEME_EDGES7_B = 7,    // Korf, edge cubies 5-11
+    SCHEME_CORNERS_SYM = 8  // cperm class * 2187 + conjugated cori
+};
+
+struct PdbHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t scheme;
+    uint32_t entry_bits;    // 8, 4 for nibble-packed tables, or 2 for depth mod 3
+    uint32_t max_depth;
+    uint64_t states;
+    uint64_t data_bytes;
+    uint64_t checksum;      // pdb_checksum over the table bytes
+    uint8_t reserved[16];
+};
+static_assert(sizeof(PdbHeader) == 64, "PDB header must stay 64 bytes");
+
+uint64_t pdb_checksum(const uint8_t *data, size_t size);
+
+// Header plus table; max_depth is taken from the table (unseen entries
+// skipped) unless given, which 2-bit tables must do
+bool write_pdb(const string &filename, PdbScheme scheme, int entry_bits,
+               long long states, const vector<uint8_t> &pdb, int max_depth = -1);
+
+// Packs exact depths (255 = unseen) into 2-bit entries, four per byte, low
+// bits first, holding depth mod 3 (3 = unseen)
+vector<uint8_t> pack_mod3(const vector<uint8_t> &depths);
+
+// ============================================================================
+// PDB LOADING
+// ============================================================================
+
+// Where table bytes live. PAGES_SHARED maps the file, so processes share the
+// page cache but every lookup risks a 4 KB TLB miss. The others copy each
+// table into private anonymous memory on 2 MB pages: PAGES_THP asks for
+// transparent huge pages, PAGES_HUGETLB takes them from the hugetlbfs pool
+// (vm.nr_hugepages) and falls back to THP when the pool is short.
+enum PdbPages { PAGES_SHARED, PAGES_THP, PAGES_HUGETLB };
+
+struct PdbLoadOptions {
+    bool populate = false;  // MAP_POPULATE: fault the whole table in at load time
+    bool verify = false;    // recompute the checksum (touches every page)
+    PdbPages pages = PAGES_SHARED;
+    bool numa = false;      // one private copy per NUMA node (implies private pages)
+};
+extern PdbLoadOptions pdb_options;
+
+// NUMA replicas are read through the calling thread's node. Searches call
+// pdb_bind_thread when they start; threads that migrate to another node keep
+// reading the old copy until the next search, so pin them (numactl, taskset)
+// for strict locality.
+const int PDB_MAX_NODES = 8;
+extern thread_local int pdb_node;
+void pdb_bind_thread();
+
+// Load progress and warnings; batch mode sends them to stderr so stdout
+// carries nothing but results
+extern ostream *log_out;
+
+// Read-only table bytes: mapped from a versioned file, owned, or copied into
+// huge-page memory (one copy per NUMA node with --pdb-numa)
+struct PdbData {
+    const uint8_t *data = nullptr;
+    size_t bytes = 0;
+    vector<uint8_t> owned;
+    void *map_base = nullptr;
+    size_t map_len = 0;
+    int max_value = 0;      // largest distance in the table
+    array<const uint8_t*,PDB_MAX_NODES> node_data{};   // data, or the node's copy
+    vector<pair<void*,size_t>> copies;
+
+    PdbData() = default;
+    PdbData(const PdbData &) = delete;
+    PdbData &operator=(const PdbData &) = delete;
+    ~PdbData() { reset(); }
+
+    bool empty() const { return bytes == 0; }
+    size_t size() const { return bytes; }
+    uint8_t operator[](size_t i) const { return node_data[pdb_node][i]; }
+    void prefetch(size_t i) const { __builtin_prefetch(node_data[pdb_node] + i); }
+
+    void reset();
+};
+
+extern PdbData pdb_corners;
+extern bool pdb_corners_sym;    // pdb_corners holds the symmetry-reduced table
+extern bool pdb_corners_mod3;   // ... as 2-bit depth mod 3 entries
+extern PdbData pdb_edges_a;
+extern PdbData pdb_edges_b;
+
+// Korf edge PDBs: 4-bit entries, two per byte, low nibble first
+struct EdgePdb {
+    PdbData data;
+    int edges = 0;   // 6 or 7 cubies
+    int first = 0;   // cubies first .. first+edges-1
+};
+extern EdgePdb pdb_korf_a;
+extern EdgePdb pdb_korf_b;
+
+inline int pdb_nibble(const PdbData &pdb, long long idx) {
+    return (pdb[idx >> 1] >> ((idx & 1) << 2)) & 0xF;
+}
+
+// A 2-bit table stores each distance mod 3. One move changes an exact
+// pattern distance by at most 1, so a child's distance is the one of
+// parent - 1, parent and parent + 1 with the stored residue.
+inline int pdb_mod3(const PdbData &pdb, long long idx) {
+    return (pdb[idx >> 2] >> ((idx & 3) << 1)) & 3;
+}
+
+inline int mod3_child_depth(int parent, int residue) {
+    return parent + (residue - parent % 3 + 4) % 3 - 1;
+}
+
+// Exact corner distance from the loaded corner table. A 2-bit table has no
+// parent to go by here, so this walks down to solved through neighbours one
+// residue lower, at most 11 moves of 18 lookups each.
+int corner_distance(const CoordCube &c);
+
+// Also look edge PDBs up from the R/L and F/B axes (--no-sym-lookups turns it
+// off); read by load_pdbs
+extern bool sym_lookups;
+
+// Also look the Korf edge tables up for the inverse cube (--dual). Lazy
+// lookups are skipped past the cutoff like any other term; eager ones are
+// always made. The corner table gets none: its values are exact corner-group
+// distances, the same for X and X^-1.
+enum DualMode { DUAL_OFF, DUAL_LAZY, DUAL_EAGER };
+extern DualMode dual_mode;
+
+extern array<int,6> subset_a;
+extern array<int,6> subset_b;
+
+// A table of `states` entries of entry_bits each. A versioned file must
+// match in scheme, width, state count and size; a raw one in size.
+bool load_pdb(const string &filename, PdbData &pdb, long long states,
+              PdbScheme scheme, int entry_bits);
+
+// Bytes of the table, over all its copies, that are mapped with 2 MB pages
+// right now (Linux; 0 elsewhere). A file mapping only counts pages that
+// have been touched.
+size_t pdb_huge_bytes(const PdbData &pdb);
+void load_pdbs();
+
+// ============================================================================
+// PDB HEURISTIC
+// ============================================================================
+
+// The table that supplied the heuristic value; on a tie the first one looked up
+enum HSource {
+    H_NONE,             // h = 0
+    H_CORNERS,
+    H_KORF_A,
+    H_KORF_B,
+    H_EDGES_A,
+    H_EDGES_B,
+    H_KORF_A_SYM,       // Korf A seen from the R/L or F/B axis
+    H_KORF_B_SYM,
+    H_KORF_A_DUAL,      // the Korf tables looked up for the inverse cube
+    H_KORF_B_DUAL,
+    H_FALLBACK,         // misplaced-piece count, no PDB loaded
+    H_SOURCES
+};
+extern const char *h_source_names[H_SOURCES];
+
+// One lookup of heuristic_pdb. load_pdbs lists a term for every table it
+// found, in the order they are tried, and the heuristic is their max. Sums
+// would need patterns no single move changes together; every face turn moves
+// corners and edges of both halves, so none of these tables can be added.
+struct HeuristicTerm {
+    HSource source;
+    int max_value;          // the term can't raise h past this
+    const EdgePdb *korf;    // Korf lookups
+    int sym;                // conjugating symmetry of a Korf lookup, 0 for none
+    bool eager;             // made even past the cutoff
+};
+extern vector<HeuristicTerm> heuristic_terms;
+void build_heuristic_terms();    // called by load_pdbs
+
+// The indices of the corner and primary Korf lookups, and the decoded edges
+// they came from. heuristic_prefetch fills one in and starts loading those
+// table entries, so a search can prefetch for every child of a node before
+// it looks any of them up. With a 2-bit corner table the search also sets
+// corner_parent, the parent's exact corner distance, and heuristic_pdb
+// leaves the node's own in corner_depth for its children.
+struct HeuristicProbe {
+    long long corner = -1;
+    long long korf[2] = {-1, -1};   // pdb_korf_a, pdb_korf_b
+    uint8_t pos[12], ori[12];       // slot and flip of every edge cubie
+    int corner_parent = -1;         // -1: unknown, walk down to solved
+    int corner_depth = -1;          // -1: not looked up
+};
+void heuristic_prefetch(const CoordCube &c, HeuristicProbe &probe);
+
+// Index of a Korf lookup for c, seen through symmetry sym (0 for the U/D
+// axis), and of the same lookup for c^-1, which --dual takes from the slot
+// contents of c without building the inverse
+long long korf_index(const CoordCube &c, const EdgePdb &pdb, int sym);
+long long korf_dual_index(const CoordCube &c, const EdgePdb &pdb, int sym);
+
+// A lower bound on the distance to solved. Lookups that can't raise h are
+// skipped, and so is everything after h exceeds cutoff, since the caller is
+// going to prune anyway. source, if given, receives the HSource of the
+// result. probe, if given, must come from heuristic_prefetch for c.
+int heuristic_pdb(const CoordCube &c, int cutoff = INT_MAX, int *source = nullptr,
+                  HeuristicProbe *probe = nullptr);
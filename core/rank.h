@@ -0,0 +1,98 @@
+// core/rank.h
+// Permutation ranking shared by rubiks_solver.cpp and tools/gen_pdb.cpp.
+//
+// Every rank here is a Lehmer code: each element contributes how many
+// smaller values are still unused, weighted in a mixed radix. Instead of the
+// nested comparison loops that count is one lookup in a 12-bit popcount
+// table, indexed by a bitmask of the values already seen, so a rank is a
+// fixed-length, branch-free loop the compiler unrolls. (A table rather than
+// __builtin_popcount: without -mpopcnt the builtin is a libgcc call.) The
+// numbering is the one the PDB files were generated with; rubiks_solver
+// --self-check compares it exhaustively with the plain loops.
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+const int factorial[13] = {1, 1, 2, 6, 24, 120, 720, 5040, 40320, 362880, 3628800, 39916800, 479001600};
+
+struct PopcountTable {
+    uint8_t bits[4096];
+    constexpr PopcountTable() : bits() {
+        for(int m=1; m<4096; m++) bits[m] = bits[m >> 1] + (m & 1);
+    }
+};
+inline constexpr PopcountTable popcount12;
+
+// Position of the d-th set bit of mask (d counts from 0)
+inline int select_bit(unsigned mask, int d) {
+    for(; d > 0; d--) mask &= mask - 1;
+    return __builtin_ctz(mask);
+}
+
+// Rank of a permutation of 0..7 among all 8!
+inline int rank_perm8(const uint8_t *perm) {
+    unsigned seen = 0;
+    int index = 0;
+    for(int i=0; i<8; i++) {
+        unsigned below = (1u << perm[i]) - 1;
+        index = index * (8 - i) + perm[i] - popcount12.bits[seen & below];
+        seen |= 1u << perm[i];
+    }
+    return index;
+}
+
+inline void unrank_perm8(int index, uint8_t *perm) {
+    unsigned unused = 0xFF;
+    for(int i=0; i<8; i++) {
+        int d = index / factorial[7-i];
+        index %= factorial[7-i];
+        perm[i] = select_bit(unused, d);
+        unused &= ~(1u << perm[i]);
+    }
+}
+
+// Rank of the relative order of k distinct values below 12 among all k!
+// (the values themselves do not matter, only which is smaller; the masks
+// index the 12-bit popcount table)
+inline int rank_relative(const uint8_t *values, int k) {
+    unsigned later = 0;
+    for(int i=0; i<k; i++) {
+        assert(values[i] < 12);
+        later |= 1u << values[i];
+    }
+    int index = 0;
+    for(int i=0; i<k; i++) {
+        later &= ~(1u << values[i]);
+        unsigned below = (1u << values[i]) - 1;
+        index = index * (k - i) + popcount12.bits[later & below];
+    }
+    return index;
+}
+
+// Rank of k distinct slots out of n (an element of nPk): slot i counts in
+// radix n-i, less the slots before it that are smaller
+inline long long rank_partial(const uint8_t *pos, int k, int n) {
+    unsigned seen = 0;
+    long long index = 0;
+    for(int i=0; i<k; i++) {
+        unsigned below = (1u << pos[i]) - 1;
+        index = index * (n - i) + pos[i] - popcount12.bits[seen & below];
+        seen |= 1u << pos[i];
+    }
+    return index;
+}
+
+inline void unrank_partial(long long index, int k, int n, uint8_t *pos) {
+    int digit[16];
+    for(int i=k-1; i>=0; i--) {
+        digit[i] = index % (n - i);
+        index /= n - i;
+    }
+    unsigned unused = (1u << n) - 1;
+    for(int i=0; i<k; i++) {
+        pos[i] = select_bit(unused, digit[i]);
+        unused &= ~(1u << pos[i]);
+    }
+}
@@ -0,0 +1,1301 @@
+// core/search.cpp
+// IDA*, parallel IDA*, meet in the middle and two-phase search; see search.h.
+
+#include "search.h"
+
+// ============================================================================
+// TRANSPOSITION TABLE
+// ============================================================================
+// Move pruning only catches same-face and same-axis repeats; longer cycles
+// (R U R' U' ...) still reach the same state again within one iteration. The
+// table remembers, per iteration, the smallest g each state was expanded at,
+// and a revisit is pruned when it cannot do better: a larger g, or the same g
+// in the same move-pruning state (which allows the same next moves). Entries
+// are 16 bytes in 64-byte buckets, one cache line per probe. A bucket
+// replaces entries from older iterations first, then the deepest one, since
+// shallow entries guard bigger subtrees.
+//
+// The search state is a CoordCube, so entries are keyed on its packed
+// coordinates (which are the full state) rather than on a CubeKey, which
+// would need a CubieCube per node.
+
+// Nodes closer than this to the bound are cheaper to search than to probe
+const int TT_MIN_REMAINING = 3;
+
+size_t tt_megabytes = 0;    // --tt-mb; 0 disables the table
+
+// Totals over every table, reported after a solve or batch
+TTStats tt_totals;
+mutex tt_totals_lock;
+
+struct TTEntry {
+    uint64_t lo;        // cperm, cori, edge3[0], edge3[1]
+    uint32_t hi;        // edge3[2], edge3[3]
+    uint8_t g;
+    uint8_t stamp;      // iteration that wrote it; 0 = never
+    uint16_t fsm;       // move-pruning state it was expanded in
+};
+
+struct alignas(64) TTBucket {
+    TTEntry entry[4];
+};
+static_assert(sizeof(TTBucket) == 64, "a bucket must fill one cache line");
+
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t bytes) {
+        size_t n = 1;
+        while(n * 2 * sizeof(TTBucket) <= bytes) n *= 2;
+        buckets.assign(n, TTBucket());
+        mask = n - 1;
+    }
+    
+    size_t bytes() const { return buckets.size() * sizeof(TTBucket); }
+    
+    // Entries from earlier iterations stay in place but no longer count
+    void new_iteration() {
+        if(++stamp == 0) {
+            fill(buckets.begin(), buckets.end(), TTBucket());
+            stamp = 1;
+        }
+    }
+    
+    // True if this state was already expanded this iteration at a g that
+    // covers the current visit; otherwise records the visit
+    bool seen(const CoordCube &c, int g, int fsm) {
+        uint64_t lo = (uint64_t)c.cperm << 48 | (uint64_t)c.cori << 32
+            | (uint64_t)c.edge3[0] << 16 | c.edge3[1];
+        uint32_t hi = (uint32_t)c.edge3[2] << 16 | c.edge3[3];
+        uint64_t h = (lo ^ (hi * 0x9E3779B97F4A7C15ULL)) * 0xBF58476D1CE4E5B9ULL;
+        TTBucket &b = buckets[(h ^ (h >> 31)) & mask];
+        stats.probes++;
+        
+        TTEntry *victim = &b.entry[0];
+        for(TTEntry &e : b.entry) {
+            bool live = e.stamp == stamp;
+            if(live && e.lo == lo && e.hi == hi) {
+                stats.hits++;
+                if(e.g < g || (e.g == g && e.fsm == fsm)) {
+                    stats.pruned++;
+                    return true;
+                }
+                if(g < e.g) {
+                    e.g = g;
+                    e.fsm = fsm;
+                }
+                return false;
+            }
+            bool victim_live = victim->stamp == stamp;
+            if(victim_live && (!live || e.g > victim->g)) victim = &e;
+        }
+        
+        stats.stores++;
+        if(victim->stamp == stamp) stats.replacements++;
+        *victim = TTEntry{lo, hi, (uint8_t)g, stamp, (uint16_t)fsm};
+        return false;
+    }
+    
+    // Move this table's counters into tt_totals
+    void flush_stats() {
+        lock_guard<mutex> guard(tt_totals_lock);
+        tt_totals.probes += stats.probes;
+        tt_totals.hits += stats.hits;
+        tt_totals.pruned += stats.pruned;
+        tt_totals.stores += stats.stores;
+        tt_totals.replacements += stats.replacements;
+        stats = TTStats();
+    }
+    
+private:
+    vector<TTBucket> buckets;
+    size_t mask = 0;
+    uint8_t stamp = 0;
+    TTStats stats;
+};
+
+// One table per thread, kept across solves so batch workers don't reallocate
+TranspositionTable *thread_tt() {
+    thread_local unique_ptr<TranspositionTable> tt;
+    if(tt_megabytes == 0) return nullptr;
+    if(!tt) tt.reset(new TranspositionTable(tt_megabytes << 20));
+    return tt.get();
+}
+
+void print_tt_stats() {
+    lock_guard<mutex> guard(tt_totals_lock);
+    const TTStats &s = tt_totals;
+    *log_out << "Transposition table: " << s.probes << " probes, " << s.hits << " hits, "
+             << s.pruned << " pruned, " << s.stores << " stores, "
+             << s.replacements << " replacements\n";
+}
+
+// ============================================================================
+// SEARCH STATISTICS
+// ============================================================================
+
+thread_local SearchStats *search_stats = nullptr;
+
+uint64_t IterationStats::ticks() const {
+    uint64_t total = 0;
+    for(uint64_t t : depth_ticks) total += t;
+    return total;
+}
+
+const char *SearchStats::tick_unit() {
+#if defined(__x86_64__) || defined(__i386__)
+    return "cycles";
+#else
+    return "ns";
+#endif
+}
+
+void SearchStats::begin_iteration(int bound) {
+    current = IterationStats();
+    current.bound = bound;
+    last_tick = stats_ticks();
+    last_depth = 0;
+}
+
+void SearchStats::flush() {
+    uint64_t now = stats_ticks();
+    current.depth_ticks[last_depth] += now - last_tick;
+    last_tick = now;
+}
+
+void SearchStats::end_iteration(long long nodes, double seconds) {
+    flush();
+    current.nodes = nodes;
+    current.seconds = seconds;
+    iterations.push_back(current);
+}
+
+void SearchStats::merge(const SearchStats &worker) {
+    for(int d=0; d<STATS_MAX_DEPTH; d++) {
+        current.depth_nodes[d] += worker.current.depth_nodes[d];
+        current.depth_cutoffs[d] += worker.current.depth_cutoffs[d];
+        current.depth_h[d] += worker.current.depth_h[d];
+        current.depth_ticks[d] += worker.current.depth_ticks[d];
+    }
+    for(int i=0; i<H_SOURCES; i++) h_source[i] += worker.h_source[i];
+    for(int h=0; h<STATS_MAX_H; h++) h_values[h] += worker.h_values[h];
+}
+
+// Per-depth totals over every iteration
+static IterationStats depth_totals(const vector<IterationStats> &iterations, int &max_depth) {
+    IterationStats sum;
+    max_depth = 0;
+    for(const auto &it : iterations) {
+        for(int d=0; d<STATS_MAX_DEPTH; d++) {
+            sum.depth_nodes[d] += it.depth_nodes[d];
+            sum.depth_cutoffs[d] += it.depth_cutoffs[d];
+            sum.depth_h[d] += it.depth_h[d];
+            sum.depth_ticks[d] += it.depth_ticks[d];
+            if(it.depth_nodes[d]) max_depth = max(max_depth, d);
+        }
+        sum.nodes += it.nodes;
+        sum.seconds += it.seconds;
+    }
+    return sum;
+}
+
+// Korf's effective branching factor: growth in nodes from one bound to the next
+static double iteration_ebf(const vector<IterationStats> &iterations, size_t i) {
+    if(i == 0 || iterations[i-1].nodes == 0) return 0;
+    return (double)iterations[i].nodes / iterations[i-1].nodes;
+}
+
+void SearchStats::print(ostream &out) const {
+    if(iterations.empty()) {
+        out << "No search statistics recorded\n";
+        return;
+    }
+    int max_depth;
+    IterationStats sum = depth_totals(iterations, max_depth);
+    uint64_t ticks = sum.ticks();
+    long long visited = 0;
+    for(long long n : sum.depth_nodes) visited += n;
+    
+    out << "\n=== Search statistics ===\n";
+    out << "Iteration  bound         nodes     seconds     EBF  " << tick_unit() << "/node\n";
+    for(size_t i=0; i<iterations.size(); i++) {
+        const IterationStats &it = iterations[i];
+        long long it_visited = 0;
+        for(long long n : it.depth_nodes) it_visited += n;
+        out << setw(9) << i << setw(7) << it.bound << setw(14) << it.nodes << setw(12) << fixed
+            << setprecision(4) << it.seconds << setw(8) << setprecision(2) << iteration_ebf(iterations, i)
+            << setw(13) << setprecision(1) << (it_visited ? (double)it.ticks() / it_visited : 0.0) << "\n";
+    }
+    
+    out << "\nDepth        nodes     cutoffs  branching  mean h  time %\n";
+    for(int d=0; d<=max_depth; d++) {
+        long long n = sum.depth_nodes[d], expanded = n - sum.depth_cutoffs[d];
+        double branching = d < max_depth && expanded ? (double)sum.depth_nodes[d+1] / expanded : 0.0;
+        out << setw(5) << d << setw(13) << n << setw(12) << sum.depth_cutoffs[d] << setw(11)
+            << setprecision(2) << branching << setw(8) << (n ? (double)sum.depth_h[d] / n : 0.0)
+            << setw(8) << setprecision(1) << (ticks ? 100.0 * sum.depth_ticks[d] / ticks : 0.0) << "\n";
+    }
+    
+    out << "\nMax supplied by:\n";
+    for(int i=0; i<H_SOURCES; i++) {
+        if(!h_source[i]) continue;
+        out << "  " << left << setw(12) << h_source_names[i] << right << setw(14) << h_source[i]
+            << setw(7) << setprecision(1) << 100.0 * h_source[i] / visited << "%\n";
+    }
+    
+    out << "\nh value distribution:\n";
+    for(int h=0; h<STATS_MAX_H; h++) {
+        if(!h_values[h]) continue;
+        out << "  h=" << left << setw(3) << h << right << setw(14) << h_values[h]
+            << setw(7) << setprecision(1) << 100.0 * h_values[h] / visited << "%\n";
+    }
+    
+    out << "\nTotal: " << visited << " nodes in " << setprecision(4) << sum.seconds << " sec, "
+        << setprecision(1) << (visited ? (double)ticks / visited : 0.0) << " " << tick_unit()
+        << "/node, EBF " << setprecision(2) << iteration_ebf(iterations, iterations.size() - 1) << "\n";
+    out.unsetf(ios::floatfield);
+    out << setprecision(6);
+}
+
+template<class T>
+static void json_array(ostringstream &out, const T &values, int count) {
+    out << "[";
+    for(int i=0; i<count; i++) out << (i ? "," : "") << values[i];
+    out << "]";
+}
+
+string SearchStats::json() const {
+    int max_depth;
+    IterationStats sum = depth_totals(iterations, max_depth);
+    int max_h = 0;
+    for(int h=0; h<STATS_MAX_H; h++) if(h_values[h]) max_h = h;
+    
+    ostringstream out;
+    out << setprecision(9);
+    out << "{\"tick_unit\":\"" << tick_unit() << "\",\"iterations\":[";
+    for(size_t i=0; i<iterations.size(); i++) {
+        const IterationStats &it = iterations[i];
+        out << (i ? "," : "") << "\n {\"bound\":" << it.bound << ",\"nodes\":" << it.nodes
+            << ",\"seconds\":" << it.seconds << ",\"ticks\":" << it.ticks()
+            << ",\"ebf\":" << iteration_ebf(iterations, i) << ",\"depth_nodes\":";
+        json_array(out, it.depth_nodes, max_depth + 1);
+        out << ",\"depth_cutoffs\":";
+        json_array(out, it.depth_cutoffs, max_depth + 1);
+        out << ",\"depth_h\":";
+        json_array(out, it.depth_h, max_depth + 1);
+        out << ",\"depth_ticks\":";
+        json_array(out, it.depth_ticks, max_depth + 1);
+        out << "}";
+    }
+    out << "],\n \"h_source\":{";
+    for(int i=0; i<H_SOURCES; i++) {
+        out << (i ? "," : "") << "\"" << h_source_names[i] << "\":" << h_source[i];
+    }
+    out << "},\n \"h_values\":";
+    json_array(out, h_values, max_h + 1);
+    out << ",\n \"nodes\":" << sum.nodes << ",\"seconds\":" << sum.seconds << ",\"ticks\":" << sum.ticks()
+        << ",\"ebf\":" << (iterations.empty() ? 0.0 : iteration_ebf(iterations, iterations.size() - 1)) << "}\n";
+    return out.str();
+}
+
+// ============================================================================
+// MOVE PRUNING AUTOMATON
+// ============================================================================
+// Every move sequence of up to FSM_DEPTH moves is enumerated shortest first,
+// in move-index order. A sequence is redundant if an earlier one already
+// reached the same cube, and so is any longer sequence containing it:
+// swapping in the earlier piece gives a shorter or lexicographically earlier
+// equivalent. The first shortest sequence to every position survives, so the
+// search stays optimal. This covers same-face repeats, keeps exactly one order
+// of each commuting opposite-face pair (the old test dropped both), and
+// catches the length-4 identities such as R2 L2 U2 D2 = U2 D2 R2 L2.
+//
+// A search state is the last FSM_DEPTH-1 moves of an irredundant sequence.
+// fsm_allowed[s] has one bit per move that keeps the sequence irredundant,
+// and fsm_next[s][m] is the state after it. FSM_START is the empty sequence.
+
+static vector<uint32_t> fsm_allowed;
+static vector<array<uint16_t,18>> fsm_next;
+
+void init_move_fsm() {
+    // redundant[len][code]: code is the sequence in base 18, first move most significant
+    vector<vector<bool>> redundant(FSM_DEPTH + 1);
+    unordered_set<CubeKey> reached;
+    auto first_visit = [&](const PackedCube &c) { return reached.insert(cube_key(unpack_cube(c))).second; };
+    const PackedCube solved = pack_cube(CubieCube::solved());
+    first_visit(solved);
+    int count = 1;
+    for(int len=1; len<=FSM_DEPTH; len++) {
+        count *= 18;
+        redundant[len].assign(count, false);
+        for(int code=0; code<count; code++) {
+            PackedCube c = solved;
+            for(int d=count/18; d>=1; d/=18) c = packed_apply_move(c, code / d % 18);
+            redundant[len][code] = !first_visit(c);
+        }
+    }
+    
+    // States are irredundant histories of up to FSM_DEPTH-1 moves, numbered breadth first
+    vector<vector<int>> history = {{}};
+    map<vector<int>,int> id = {{{}, FSM_START}};
+    fsm_allowed.clear();
+    fsm_next.clear();
+    for(size_t s=0; s<history.size(); s++) {
+        uint32_t allowed = 0;
+        array<uint16_t,18> next;
+        next.fill(0);
+        for(int m=0; m<18; m++) {
+            vector<int> seq = history[s];
+            seq.push_back(m);
+            bool ok = true;
+            for(int len=2; ok && len<=(int)seq.size(); len++) {
+                int code = 0;
+                for(int i=(int)seq.size()-len; i<(int)seq.size(); i++) code = code * 18 + seq[i];
+                ok = !redundant[len][code];
+            }
+            if(!ok) continue;
+            if((int)seq.size() == FSM_DEPTH) seq.erase(seq.begin());
+            auto it = id.find(seq);
+            if(it == id.end()) {
+                it = id.emplace(seq, (int)history.size()).first;
+                history.push_back(seq);
+            }
+            allowed |= 1u << m;
+            next[m] = it->second;
+        }
+        fsm_allowed.push_back(allowed);
+        fsm_next.push_back(next);
+    }
+}
+
+// ============================================================================
+// IDA* WITH PDB + PHASE 7 OPTIMIZATIONS
+// ============================================================================
+
+bool use_bpmx = false;
+thread_local const atomic<bool> *search_abort = nullptr;
+
+static bool aborted() {
+    return search_abort && search_abort->load(memory_order_relaxed);
+}
+
+BudgetClock::BudgetClock(const SearchBudget &budget, const long long *nodes)
+    : budget(budget), nodes(nodes), start(chrono::steady_clock::now()) {
+    rearm();
+}
+
+// Searches poll before counting each node, so a countdown no longer than
+// the nodes left makes the check that ends the budget land on the limit
+// itself. Polls that count nothing only bring a check forward.
+void BudgetClock::rearm() {
+    countdown = BUDGET_CHECK_INTERVAL;
+    if(budget.nodes > 0) countdown = (int)max(1LL, min<long long>(countdown, budget.nodes - *nodes));
+}
+
+double BudgetClock::elapsed() const {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+bool BudgetClock::check() {
+    rearm();
+    double t = elapsed();
+    if((budget.seconds > 0 && t >= budget.seconds) || (budget.nodes > 0 && *nodes >= budget.nodes))
+        exhausted = true;
+    if(budget.progress && t - last_report >= budget.progress_interval) report(t);
+    return exhausted;
+}
+
+void BudgetClock::set_bound(int b) {
+    bound = b;
+    if(budget.progress) report(elapsed());
+}
+
+void BudgetClock::report(double seconds) {
+    last_report = seconds;
+    SearchProgress p;
+    p.bound = bound;
+    p.nodes = *nodes;
+    p.seconds = seconds;
+    p.nodes_per_sec = seconds > 0 ? *nodes / seconds : 0;
+    budget.progress(p);
+}
+
+// heuristic_pdb, recorded in this thread's search_stats when it is set
+inline int node_heuristic(const CoordCube &node, int g, int bound, int cutoff,
+                          HeuristicProbe *probe = nullptr) {
+#ifdef RUBIK_STATS
+    if(SearchStats *st = search_stats) {
+        int source;
+        int h = heuristic_pdb(node, cutoff, &source, probe);
+        st->record_node(g, h, source, g + h > bound);
+        return h;
+    }
+#endif
+    (void)g;
+    (void)bound;
+    return heuristic_pdb(node, cutoff, nullptr, probe);
+}
+
+// Bidirectional pathmax: every child is looked up before any is searched.
+// A parent is at least h(child) - 1 from solved, so one child far enough past
+// the bound prunes the parent with its other children unsearched, and
+// h(parent) - 1 in turn bounds each child. Children keep their own cutoff,
+// so a parent is only pruned when a child's cheap lookups already show it.
+bool bpmx_search(const CoordCube &node, int h, int corner, int g, int bound, int fsm,
+                 vector<int> &path, long long &nodes, int &nextBound,
+                 const SearchCancel *cancel, TranspositionTable *tt) {
+    if(cancel && cancel->requested()) return false;
+    if(g + h > bound) {
+        nextBound = min(nextBound, g + h);
+        return false;
+    }
+    if(node == coord_solved) return true;
+    if(tt && bound - g >= TT_MIN_REMAINING && tt->seen(node, g, fsm)) return false;
+    
+    CoordCube child[18];
+    HeuristicProbe probe[18];
+    int child_h[18], child_move[18], n = 0;
+    for(uint32_t moves = fsm_allowed[fsm]; moves; moves &= moves - 1) {
+        int m = __builtin_ctz(moves);
+        child[n] = apply_move_coord(node, m);
+        heuristic_prefetch(child[n], probe[n]);
+        probe[n].corner_parent = corner;
+        child_move[n++] = m;
+    }
+    for(int i=0; i<n; i++) {
+        if(cancel && cancel->requested()) return false;
+        nodes++;
+        int hc = node_heuristic(child[i], g + 1, bound, bound - g - 1, &probe[i]);
+        if(hc - 1 > bound - g) {
+            nextBound = min(nextBound, g + hc - 1);
+            return false;
+        }
+        child_h[i] = max(hc, h - 1);
+    }
+    for(int i=0; i<n; i++) {
+        if(cancel && cancel->requested()) return false;
+        path.push_back(child_move[i]);
+        if(bpmx_search(child[i], child_h[i], probe[i].corner_depth, g+1, bound, fsm_next[fsm][child_move[i]],
+                       path, nodes, nextBound, cancel, tt))
+            return true;
+        path.pop_back();
+    }
+    return false;
+}
+
+// A node within the bound, counted and looked up by its parent. All children
+// are generated and their table entries prefetched before the first lookup,
+// so the cache misses of up to 15 siblings overlap instead of queueing one
+// behind another, and children past the bound are cut without a call.
+// corner is the node's exact corner distance (-1 if unknown), from which a
+// 2-bit corner table gives the children theirs.
+bool expand_node(const CoordCube &node, int corner, int g, int bound, int fsm,
+                 vector<int> &path, long long &nodes, int &nextBound,
+                 const SearchCancel *cancel, TranspositionTable *tt) {
+    if(node == coord_solved) return true;
+    if(tt && bound - g >= TT_MIN_REMAINING && tt->seen(node, g, fsm)) return false;
+    
+    CoordCube child[18];
+    HeuristicProbe probe[18];
+    int child_move[18], n = 0;
+    for(uint32_t moves = fsm_allowed[fsm]; moves; moves &= moves - 1) {
+        int m = __builtin_ctz(moves);
+        child[n] = apply_move_coord(node, m);
+        heuristic_prefetch(child[n], probe[n]);
+        probe[n].corner_parent = corner;
+        child_move[n++] = m;
+    }
+    int child_h[18];
+    for(int i=0; i<n; i++) {
+        if(cancel && cancel->requested()) return false;
+        nodes++;
+        child_h[i] = node_heuristic(child[i], g + 1, bound, bound - g - 1, &probe[i]);
+    }
+    for(int i=0; i<n; i++) {
+        if(g + 1 + child_h[i] > bound) {
+            nextBound = min(nextBound, g + 1 + child_h[i]);
+            continue;
+        }
+        if(cancel && cancel->requested()) return false;
+        path.push_back(child_move[i]);
+        if(expand_node(child[i], probe[i].corner_depth, g+1, bound, fsm_next[fsm][child_move[i]], path, nodes,
+                       nextBound, cancel, tt))
+            return true;
+        path.pop_back();
+    }
+    return false;
+}
+
+bool ida_search_pdb(const CoordCube &node, int g, int bound, int fsm,
+                    vector<int> &path, long long &nodes, int &nextBound,
+                    const SearchCancel *cancel, TranspositionTable *tt) {
+    if(cancel && cancel->requested()) return false;
+    nodes++;
+    
+    HeuristicProbe probe;
+    heuristic_prefetch(node, probe);
+    int h = node_heuristic(node, g, bound, bound - g, &probe);
+    if(use_bpmx) return bpmx_search(node, h, probe.corner_depth, g, bound, fsm, path, nodes, nextBound, cancel, tt);
+    int f = g + h;
+    
+    if(f > bound) {
+        nextBound = min(nextBound, f);
+        return false;
+    }
+    return expand_node(node, probe.corner_depth, g, bound, fsm, path, nodes, nextBound, cancel, tt);
+}
+
+bool ida_star_solve_pdb(CubieCube start_cube, int max_depth, vector<int> &solution, long long &nodes) {
+    nodes = 0;
+    pdb_bind_thread();
+    CoordCube start = to_coord(start_cube);
+    int bound = heuristic_pdb(start);
+    if(start == coord_solved) { solution.clear(); return true; }
+    
+    TranspositionTable *tt = thread_tt();
+    SearchCancel stop{nullptr, 0, search_abort};
+    const SearchCancel *cancel = search_abort ? &stop : nullptr;
+    bool found = false;
+    for(int iter=0; iter<50 && !aborted(); iter++) {
+        vector<int> path;
+        int nextBound = INT_MAX;
+        if(tt) tt->new_iteration();
+        SearchStats *st = search_stats;
+        long long iter_nodes = nodes;
+        auto iter_start = chrono::steady_clock::now();
+        if(st) st->begin_iteration(bound);
+        found = ida_search_pdb(start, 0, bound, FSM_START, path, nodes, nextBound, cancel, tt);
+        if(st) st->end_iteration(nodes - iter_nodes,
+                                 chrono::duration<double>(chrono::steady_clock::now() - iter_start).count());
+        if(found) {
+            solution = path;
+            break;
+        }
+        if(nextBound == INT_MAX || nextBound > max_depth) break;
+        bound = nextBound;
+    }
+    if(tt) tt->flush_stats();
+    return found;
+}
+
+// ============================================================================
+// PARALLEL IDA*
+// ============================================================================
+// Each iteration is expanded to split_depth on the calling thread. The
+// subtrees below that frontier are dealt in lexicographic move order to
+// per-worker deques; a worker pops its own deque from the front and steals
+// from the back of the others when it runs dry.
+
+struct SearchTask {
+    CoordCube node;
+    int g;
+    int fsm;
+    vector<int> path;
+};
+
+struct TaskDeque {
+    mutex lock;
+    deque<int> tasks;
+};
+
+// Same pruning as ida_search_pdb, but children at split_depth become tasks.
+// A solved node above the frontier is emitted as its own task and ends the walk.
+bool split_frontier(const CoordCube &node, int g, int bound, int split_depth, int fsm,
+                    vector<int> &path, long long &nodes, int &nextBound, vector<SearchTask> &tasks) {
+    nodes++;
+    
+    int f = g + node_heuristic(node, g, bound, bound - g);
+    if(f > bound) {
+        nextBound = min(nextBound, f);
+        return false;
+    }
+    if(node == coord_solved) {
+        tasks.push_back({node, g, fsm, path});
+        return true;
+    }
+    
+    for(uint32_t moves = fsm_allowed[fsm]; moves; moves &= moves - 1) {
+        int m = __builtin_ctz(moves);
+        path.push_back(m);
+        CoordCube next = apply_move_coord(node, m);
+        int next_fsm = fsm_next[fsm][m];
+        if(g + 1 >= split_depth) {
+            tasks.push_back({next, g + 1, next_fsm, path});
+        } else if(split_frontier(next, g+1, bound, split_depth, next_fsm, path, nodes, nextBound, tasks)) {
+            return true;
+        }
+        path.pop_back();
+    }
+    return false;
+}
+
+inline void atomic_min(atomic<int> &target, int value) {
+    int cur = target.load(memory_order_relaxed);
+    while(value < cur && !target.compare_exchange_weak(cur, value, memory_order_relaxed)) {}
+}
+
+bool ida_star_solve_pdb_parallel(CubieCube start_cube, int max_depth, const ParallelOptions &opt,
+                                 vector<int> &solution, long long &nodes, vector<WorkerStats> &stats) {
+    nodes = 0;
+    stats.assign(opt.threads, WorkerStats());
+    CoordCube start = to_coord(start_cube);
+    int bound = heuristic_pdb(start);
+    if(start == coord_solved) { solution.clear(); return true; }
+    
+    // One table per worker. Deterministic mode goes without: a cancelled
+    // subtree leaves entries behind that could cut an earlier task's search.
+    vector<unique_ptr<TranspositionTable>> tables;
+    if(tt_megabytes > 0 && !opt.deterministic) {
+        for(int i=0; i<opt.threads; i++) {
+            tables.emplace_back(new TranspositionTable((tt_megabytes << 20) / opt.threads));
+        }
+    }
+    SearchStats *main_stats = search_stats;
+    const atomic<bool> *abort = search_abort;
+    auto finish = [&](bool found) {
+        for(const auto &ws : stats) nodes += ws.nodes;
+        for(auto &tt : tables) tt->flush_stats();
+        return found;
+    };
+    
+    for(int iter=0; iter<50 && !aborted(); iter++) {
+        for(auto &tt : tables) tt->new_iteration();
+        long long iter_nodes = nodes;
+        for(const auto &ws : stats) iter_nodes += ws.nodes;
+        auto iter_start = chrono::steady_clock::now();
+        if(main_stats) main_stats->begin_iteration(bound);
+        // Workers record into their own statistics, merged after the
+        // iteration; fresh ones each time, so no count is merged twice
+        vector<SearchStats> worker_stats(main_stats ? opt.threads : 0);
+        vector<SearchTask> tasks;
+        vector<int> prefix;
+        int frontierBound = INT_MAX;
+        split_frontier(start, 0, bound, opt.split_depth, FSM_START, prefix, nodes, frontierBound, tasks);
+        
+        // Deal contiguous blocks so each worker starts on its own part of the order
+        vector<TaskDeque> deques(opt.threads);
+        for(size_t t=0; t<tasks.size(); t++) {
+            deques[t * opt.threads / tasks.size()].tasks.push_back((int)t);
+        }
+        
+        atomic<int> nextBound(frontierBound);
+        atomic<int> best_task(INT_MAX);
+        mutex solution_lock;
+        vector<int> best_path;
+        
+        if(main_stats) main_stats->flush();
+        
+        auto worker = [&](int id) {
+            auto t0 = chrono::steady_clock::now();
+            pdb_bind_thread();
+            WorkerStats &ws = stats[id];
+            if(main_stats) {
+                search_stats = &worker_stats[id];
+                search_stats->begin_iteration(bound);
+            }
+            while(true) {
+                int t = -1;
+                {
+                    lock_guard<mutex> guard(deques[id].lock);
+                    if(!deques[id].tasks.empty()) {
+                        t = deques[id].tasks.front();
+                        deques[id].tasks.pop_front();
+                    }
+                }
+                for(int v=1; t < 0 && v < opt.threads; v++) {
+                    TaskDeque &victim = deques[(id + v) % opt.threads];
+                    lock_guard<mutex> guard(victim.lock);
+                    if(!victim.tasks.empty()) {
+                        t = victim.tasks.back();
+                        victim.tasks.pop_back();
+                        ws.steals++;
+                    }
+                }
+                if(t < 0) break;
+                
+                SearchCancel cancel{&best_task, opt.deterministic ? t : INT_MAX, abort};
+                if(cancel.requested()) continue;
+                
+                ws.tasks++;
+                const SearchTask &task = tasks[t];
+                vector<int> path = task.path;
+                int localBound = INT_MAX;
+                TranspositionTable *tt = tables.empty() ? nullptr : tables[id].get();
+                if(ida_search_pdb(task.node, task.g, bound, task.fsm, path, ws.nodes, localBound,
+                                  &cancel, tt)) {
+                    lock_guard<mutex> guard(solution_lock);
+                    if(t < best_task.load()) {
+                        best_path = path;
+                        best_task.store(t);
+                    }
+                }
+                atomic_min(nextBound, localBound);
+            }
+            if(main_stats) search_stats->flush();
+            ws.seconds += chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        };
+        
+        vector<thread> pool;
+        for(int i=0; i<opt.threads; i++) pool.emplace_back(worker, i);
+        for(auto &th : pool) th.join();
+        
+        if(main_stats) {
+            long long total = nodes - iter_nodes;
+            for(const auto &ws : stats) total += ws.nodes;
+            for(const auto &w : worker_stats) main_stats->merge(w);
+            main_stats->last_tick = SearchStats::stats_ticks();
+            main_stats->end_iteration(total, chrono::duration<double>(chrono::steady_clock::now() - iter_start).count());
+        }
+        
+        if(best_task.load() != INT_MAX) {
+            solution = best_path;
+            return finish(true);
+        }
+        
+        int nb = nextBound.load();
+        if(nb == INT_MAX || nb > max_depth) break;
+        bound = nb;
+    }
+    return finish(false);
+}
+
+// ============================================================================
+// MEET IN THE MIDDLE
+// ============================================================================
+// The backward frontier is an open-addressing table of 8-byte entries: a
+// 61-bit fingerprint of the state above a 3-bit distance, 0 meaning empty.
+// It is filled by a depth-first walk from solved over the move automaton,
+// which reaches every state by some shortest sequence, keeping the smallest
+// distance seen per state.
+//
+// Inside the radius, a state missing from the table is at least depth+1
+// moves out, and one in it is exactly its stored distance. Taking that as a
+// second heuristic keeps IDA* admissible, so the first bound that reaches the
+// frontier is the optimal length and no node below bound - depth is expanded.
+// A fingerprint collision can only make a stored distance too small, which
+// is still admissible; if the walk back to solved then fails, the node is
+// expanded like any other.
+
+static const long long MITM_STATES[MITM_MAX_DEPTH + 1] = {
+    1, 19, 262, 3502, 46741, 621649, 8240087, 109043123    // within d moves, half-turn metric
+};
+
+class MitmFrontier {
+public:
+    explicit MitmFrontier(int depth) : depth(depth), slots(capacity(depth), 0) {}
+
+    // Load factor at most 3/4
+    static size_t capacity(int depth) { return MITM_STATES[depth] / 3 * 4 + 4; }
+    static size_t bytes_for(int depth) { return capacity(depth) * sizeof(uint64_t); }
+
+    size_t bytes() const { return slots.size() * sizeof(uint64_t); }
+
+    void build() { fill_from(coord_solved, 0, FSM_START); }
+
+    // Distance to solved, or -1 if the state is more than depth moves out
+    int lookup(const CoordCube &c) const {
+        uint64_t key = fingerprint(c);
+        for(size_t i = slot_of(key); ; i = i + 1 == slots.size() ? 0 : i + 1) {
+            uint64_t e = slots[i];
+            if(e == 0) return -1;
+            if((e & ~7ULL) == key) return (int)(e & 7);
+        }
+    }
+
+    // Appends the moves from c down to solved, stepping to a neighbour with a
+    // smaller distance each time; false (path unchanged) if that fails
+    bool descend(CoordCube c, vector<int> &path) const {
+        size_t base = path.size();
+        for(int d = lookup(c); d > 0; ) {
+            int m = 0, next_d = -1;
+            CoordCube next;
+            for(; m < 18; m++) {
+                next = apply_move_coord(c, m);
+                next_d = lookup(next);
+                if(next_d >= 0 && next_d < d) break;
+            }
+            if(m == 18) break;
+            path.push_back(m);
+            c = next;
+            d = next_d;
+        }
+        if(c == coord_solved) return true;
+        path.resize(base);
+        return false;
+    }
+
+    const int depth;
+    size_t states = 0;
+
+private:
+    vector<uint64_t> slots;
+
+    static uint64_t fingerprint(const CoordCube &c) {
+        uint64_t lo = (uint64_t)c.cperm << 48 | (uint64_t)c.cori << 32
+            | (uint64_t)c.edge3[0] << 16 | c.edge3[1];
+        uint32_t hi = (uint32_t)c.edge3[2] << 16 | c.edge3[3];
+        uint64_t key = mix64(lo ^ mix64(hi)) & ~7ULL;
+        return key ? key : 8;
+    }
+
+    size_t slot_of(uint64_t key) const {
+        return (size_t)((unsigned __int128)key * slots.size() >> 64);
+    }
+
+    void insert(const CoordCube &c, int d) {
+        uint64_t key = fingerprint(c);
+        for(size_t i = slot_of(key); ; i = i + 1 == slots.size() ? 0 : i + 1) {
+            uint64_t &e = slots[i];
+            if(e == 0) {
+                e = key | d;
+                states++;
+                return;
+            }
+            if((e & ~7ULL) == key) {
+                if(d < (int)(e & 7)) e = key | d;
+                return;
+            }
+        }
+    }
+
+    void fill_from(const CoordCube &c, int d, int fsm) {
+        insert(c, d);
+        if(d == depth) return;
+        for(uint32_t moves = fsm_allowed[fsm]; moves; moves &= moves - 1) {
+            int m = __builtin_ctz(moves);
+            fill_from(apply_move_coord(c, m), d + 1, fsm_next[fsm][m]);
+        }
+    }
+};
+
+static mutex mitm_lock;
+static unique_ptr<MitmFrontier> mitm_table;
+static double mitm_build_seconds = 0;
+
+static int mitm_depth_for(const MitmOptions &opt) {
+    size_t cap = opt.megabytes << 20;
+    int fits = 0;
+    while(fits < MITM_MAX_DEPTH && MitmFrontier::bytes_for(fits + 1) <= cap) fits++;
+    if(opt.depth <= 0) return fits;
+    int depth = min(opt.depth, MITM_MAX_DEPTH);
+    if(depth > fits) {
+        *log_out << "Warning: A depth-" << depth << " frontier needs "
+                 << (MitmFrontier::bytes_for(depth) >> 20) << " MB, over the " << opt.megabytes
+                 << " MB cap; using depth " << fits << "\n";
+        depth = fits;
+    }
+    return depth;
+}
+
+static const MitmFrontier *mitm_frontier(const MitmOptions &opt) {
+    lock_guard<mutex> guard(mitm_lock);
+    int depth = mitm_depth_for(opt);
+    if(depth < 1) return nullptr;
+    if(mitm_table && mitm_table->depth == depth) return mitm_table.get();
+
+    mitm_table.reset();
+    *log_out << "Building depth-" << depth << " frontier (" << MITM_STATES[depth] << " states, "
+             << (MitmFrontier::bytes_for(depth) >> 20) << " MB)...\n";
+    auto t0 = chrono::steady_clock::now();
+    mitm_table.reset(new MitmFrontier(depth));
+    mitm_table->build();
+    mitm_build_seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    if(mitm_table->states != (size_t)MITM_STATES[depth]) {
+        *log_out << "Warning: Frontier holds " << mitm_table->states << " states, expected "
+                 << MITM_STATES[depth] << "\n";
+    }
+    *log_out << "[OK] Frontier built in " << mitm_build_seconds << " sec\n";
+    return mitm_table.get();
+}
+
+bool mitm_prepare(const MitmOptions &opt, MitmInfo *info) {
+    const MitmFrontier *f = mitm_frontier(opt);
+    if(!f) return false;
+    if(info) {
+        info->depth = f->depth;
+        info->states = f->states;
+        info->bytes = f->bytes();
+        info->build_seconds = mitm_build_seconds;
+    }
+    return true;
+}
+
+// parent_corner is the parent's exact corner distance, -1 at the root
+bool mitm_search(const MitmFrontier &frontier, const CoordCube &node, int parent_corner, int g, int bound, int fsm,
+                 vector<int> &path, long long &nodes, int &nextBound, const SearchCancel *cancel) {
+    if(cancel && cancel->requested()) return false;
+    nodes++;
+    int remaining = bound - g;
+    HeuristicProbe probe;
+    heuristic_prefetch(node, probe);
+    probe.corner_parent = parent_corner;
+    int h = node_heuristic(node, g, bound, remaining, &probe);
+    if(h > remaining) {
+        nextBound = min(nextBound, g + h);
+        return false;
+    }
+    if(remaining <= frontier.depth) {
+        int d = frontier.lookup(node);
+        if(d < 0) d = frontier.depth + 1;
+        if(d > remaining) {
+            nextBound = min(nextBound, g + d);
+            return false;
+        }
+        if(frontier.descend(node, path)) return true;
+        // A fingerprint collision sent the walk astray; search the node's
+        // children instead, so no solution within the bound is skipped
+    }
+
+    for(uint32_t moves = fsm_allowed[fsm]; moves; moves &= moves - 1) {
+        int m = __builtin_ctz(moves);
+        path.push_back(m);
+        if(mitm_search(frontier, apply_move_coord(node, m), probe.corner_depth, g+1, bound, fsm_next[fsm][m],
+                       path, nodes, nextBound, cancel))
+            return true;
+        path.pop_back();
+    }
+    return false;
+}
+
+bool mitm_solve(const CubieCube &start_cube, int max_depth, const MitmOptions &opt,
+                vector<int> &solution, long long &nodes) {
+    const MitmFrontier *frontier = mitm_frontier(opt);
+    if(!frontier) return ida_star_solve_pdb(start_cube, max_depth, solution, nodes);
+
+    nodes = 0;
+    pdb_bind_thread();
+    CoordCube start = to_coord(start_cube);
+    int d = frontier->lookup(start);
+    if(d >= 0) {
+        solution.clear();
+        if(d > max_depth) return false;
+        if(frontier->descend(start, solution)) return true;
+        return ida_star_solve_pdb(start_cube, max_depth, solution, nodes);
+    }
+
+    int bound = max(heuristic_pdb(start), frontier->depth + 1);
+    SearchCancel stop{nullptr, 0, search_abort};
+    const SearchCancel *cancel = search_abort ? &stop : nullptr;
+    bool found = false;
+    while(bound <= max_depth && !aborted()) {
+        vector<int> path;
+        int nextBound = INT_MAX;
+        SearchStats *st = search_stats;
+        long long iter_nodes = nodes;
+        auto iter_start = chrono::steady_clock::now();
+        if(st) st->begin_iteration(bound);
+        found = mitm_search(*frontier, start, -1, 0, bound, FSM_START, path, nodes, nextBound, cancel);
+        if(st) st->end_iteration(nodes - iter_nodes,
+                                 chrono::duration<double>(chrono::steady_clock::now() - iter_start).count());
+        if(found) {
+            solution = path;
+            break;
+        }
+        if(nextBound == INT_MAX) break;
+        bound = nextBound;
+    }
+    return found;
+}
+
+// ============================================================================
+// TWO-PHASE SOLVER
+// ============================================================================
+// Kociemba's two-phase algorithm for fast, suboptimal answers. Phase 1 brings
+// the cube into <U,D,R2,L2,F2,B2> (corner twist, edge flip and the position of
+// the four slice edges solved); phase 2 solves it inside that subgroup. Every
+// phase-1 solution of increasing length is tried, so the answer keeps getting
+// shorter until it reaches the target length or the time budget runs out.
+
+const int N_FLIP = 2048;      // orientation of edges 0..10
+const int N_SLICE = 495;      // slots holding the slice edges 8..11, C(12,4)
+const int N_UDEDGE = 40320;   // permutation of edges 0..7 (phase 2)
+const int N_SLICEPERM = 24;   // permutation of edges 8..11 (phase 2)
+
+// Phase-2 moves: U, D turns and the half turns of the side faces
+static const int P2_MOVES[10] = {U, D, Up, Dp, U2, D2, R2, F2, L2, B2};
+
+static uint16_t flip_move[N_FLIP][18];
+static uint16_t slice_move[N_SLICE][18];
+static uint16_t udedge_move[N_UDEDGE][10];
+static uint8_t sliceperm_move[N_SLICEPERM][10];
+static int slice_rank[4096];
+static int slice_mask[N_SLICE];
+static vector<uint8_t> prune_twist_slice;    // cori * N_SLICE + slice
+static vector<uint8_t> prune_flip_slice;     // flip * N_SLICE + slice
+static vector<uint8_t> prune_cperm_sperm;    // cperm * 24 + sliceperm
+static vector<uint8_t> prune_udedge_sperm;   // udedge * 24 + sliceperm
+static once_flag two_phase_once;
+
+int encode_flip(const array<uint8_t,12> &eo) {
+    int index = 0;
+    for(int i=0; i<11; i++) index = index * 2 + eo[i];
+    return index;
+}
+
+int encode_slice(const array<uint8_t,12> &ep) {
+    int mask = 0;
+    for(int i=0; i<12; i++) if(ep[i] >= 8) mask |= 1 << i;
+    return slice_rank[mask];
+}
+
+int encode_udedge(const array<uint8_t,12> &ep) {
+    array<uint8_t,8> perm;
+    for(int i=0; i<8; i++) perm[i] = ep[i];
+    return encode_permutation_8(perm);
+}
+
+int encode_sliceperm(const array<uint8_t,12> &ep) {
+    return rank_relative(ep.data() + 8, 4);
+}
+
+// Breadth-first distance table over a product coordinate a * nb + b
+template<typename NextA, typename NextB>
+vector<uint8_t> build_prune_table(int na, int nb, int solved, int moves, NextA next_a, NextB next_b) {
+    vector<uint8_t> table((size_t)na * nb, 255);
+    table[solved] = 0;
+    int filled = 1;
+    for(int depth=0; filled < na * nb; depth++) {
+        int found = 0;
+        for(int idx=0; idx<na*nb; idx++) {
+            if(table[idx] != depth) continue;
+            int a = idx / nb, b = idx % nb;
+            for(int m=0; m<moves; m++) {
+                int next = next_a(a, m) * nb + next_b(b, m);
+                if(table[next] == 255) { table[next] = depth + 1; found++; }
+            }
+        }
+        if(found == 0) break;
+        filled += found;
+    }
+    return table;
+}
+
+void init_two_phase_tables() {
+    int n = 0;
+    for(int mask=0; mask<4096; mask++) {
+        slice_rank[mask] = -1;
+        if(__builtin_popcount(mask) == 4) { slice_rank[mask] = n; slice_mask[n++] = mask; }
+    }
+    
+    for(int m=0; m<18; m++) {
+        CubieCube mv = apply_move(CubieCube::solved(), m);
+        for(int idx=0; idx<N_FLIP; idx++) {
+            CubieCube c;
+            int sum = 0;
+            for(int i=10; i>=0; i--) { c.eo[i] = (idx >> (10 - i)) & 1; sum += c.eo[i]; }
+            c.eo[11] = sum & 1;
+            flip_move[idx][m] = encode_flip((c * mv).eo);
+        }
+        for(int idx=0; idx<N_SLICE; idx++) {
+            CubieCube c;
+            int slice = 8, other = 0;
+            for(int i=0; i<12; i++) c.ep[i] = (slice_mask[idx] >> i & 1) ? slice++ : other++;
+            slice_move[idx][m] = encode_slice((c * mv).ep);
+        }
+    }
+    for(int k=0; k<10; k++) {
+        CubieCube mv = apply_move(CubieCube::solved(), P2_MOVES[k]);
+        for(int idx=0; idx<N_UDEDGE; idx++) {
+            CubieCube c;
+            array<uint8_t,8> perm;
+            decode_permutation_8(idx, perm);
+            for(int i=0; i<8; i++) c.ep[i] = perm[i];
+            udedge_move[idx][k] = encode_udedge((c * mv).ep);
+        }
+        for(int idx=0; idx<N_SLICEPERM; idx++) {
+            CubieCube c;
+            array<uint8_t,8> perm;
+            decode_permutation_8(idx, perm);   // idx < 24 permutes only the last four
+            for(int i=0; i<4; i++) c.ep[8+i] = 8 + perm[4+i] - 4;
+            sliceperm_move[idx][k] = encode_sliceperm((c * mv).ep);
+        }
+    }
+    
+    CubieCube solved;
+    int slice0 = encode_slice(solved.ep);
+    prune_twist_slice = build_prune_table(N_CORI, N_SLICE, slice0, 18,
+        [](int a, int m) { return cori_move[a][m]; }, [](int b, int m) { return slice_move[b][m]; });
+    prune_flip_slice = build_prune_table(N_FLIP, N_SLICE, slice0, 18,
+        [](int a, int m) { return flip_move[a][m]; }, [](int b, int m) { return slice_move[b][m]; });
+    prune_cperm_sperm = build_prune_table(N_CPERM, N_SLICEPERM, 0, 10,
+        [](int a, int m) { return cperm_move[a][P2_MOVES[m]]; }, [](int b, int m) { return sliceperm_move[b][m]; });
+    prune_udedge_sperm = build_prune_table(N_UDEDGE, N_SLICEPERM, 0, 10,
+        [](int a, int m) { return udedge_move[a][m]; }, [](int b, int m) { return sliceperm_move[b][m]; });
+}
+
+class TwoPhaseSearch {
+public:
+    TwoPhaseSearch(const CubieCube &start, const TwoPhaseOptions &opt)
+        : start_(start), opt_(opt), deadline_(chrono::steady_clock::now()
+              + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(opt.time_budget))) {}
+    
+    bool run(vector<int> &solution, long long &nodes) {
+        int twist = encode_orientation_corners(start_.co);
+        int flip = encode_flip(start_.eo);
+        int slice = encode_slice(start_.ep);
+        for(int d1=0; d1<=opt_.max_phase1 && !done(); d1++) {
+            phase1(twist, flip, slice, d1, -1);
+        }
+        nodes = nodes_;
+        solution = best_;
+        return have_best_;
+    }
+    
+private:
+    CubieCube start_;
+    TwoPhaseOptions opt_;
+    chrono::steady_clock::time_point deadline_;
+    vector<int> path_;
+    vector<int> best_;
+    bool have_best_ = false;
+    bool timed_out_ = false;
+    long long nodes_ = 0;
+    
+    // The budget only cuts off improvement: the first solution is always
+    // completed. An abort stops the search either way.
+    bool out_of_time() {
+        if(!timed_out_ && (nodes_ & 1023) == 0
+           && ((have_best_ && chrono::steady_clock::now() > deadline_) || aborted()))
+            timed_out_ = true;
+        return timed_out_;
+    }
+    
+    bool done() {
+        return (have_best_ && (int)best_.size() <= opt_.target) || out_of_time();
+    }
+    
+    static bool is_phase2_move(int m) {
+        return m >= 12 || m % 6 == U || m % 6 == D;
+    }
+    
+    // Same face twice, or opposite faces in the non-canonical order
+    static bool redundant(int face, int prevFace) {
+        return prevFace != -1 && (face == prevFace || (face % 3 == prevFace % 3 && face < prevFace));
+    }
+    
+    void phase1(int twist, int flip, int slice, int depth, int prevFace) {
+        nodes_++;
+        if(depth == 0) {
+            if(twist == 0 && flip == 0 && slice_mask[slice] == 0xF00) {
+                // A phase-1 move that is also a phase-2 move means a shorter phase 1 exists
+                if(path_.empty() || !is_phase2_move(path_.back())) phase2_from_leaf();
+            }
+            return;
+        }
+        for(int m=0; m<18 && !done(); m++) {
+            int face = m % 6;
+            if(redundant(face, prevFace)) continue;
+            int t = cori_move[twist][m], f = flip_move[flip][m], s = slice_move[slice][m];
+            if(max(prune_twist_slice[t * N_SLICE + s], prune_flip_slice[f * N_SLICE + s]) >= depth) continue;
+            path_.push_back(m);
+            phase1(t, f, s, depth - 1, face);
+            path_.pop_back();
+        }
+    }
+    
+    void phase2_from_leaf() {
+        CubieCube c = start_;
+        for(int m : path_) c = apply_move(c, m);
+        int cperm = encode_permutation_8(c.cp);
+        int udedge = encode_udedge(c.ep);
+        int sperm = encode_sliceperm(c.ep);
+        
+        int limit = opt_.max_phase2;
+        if(have_best_) limit = min(limit, (int)best_.size() - 1 - (int)path_.size());
+        int h = max(prune_cperm_sperm[cperm * 24 + sperm], prune_udedge_sperm[udedge * 24 + sperm]);
+        int prevFace = path_.empty() ? -1 : path_.back() % 6;
+        size_t phase1_len = path_.size();
+        for(int d2=h; d2<=limit && !out_of_time(); d2++) {
+            if(phase2(cperm, udedge, sperm, d2, prevFace)) {
+                best_ = path_;
+                have_best_ = true;
+                path_.resize(phase1_len);
+                return;
+            }
+        }
+    }
+    
+    bool phase2(int cperm, int udedge, int sperm, int depth, int prevFace) {
+        nodes_++;
+        if(depth == 0) return cperm == 0 && udedge == 0 && sperm == 0;
+        if(out_of_time()) return false;
+        for(int k=0; k<10; k++) {
+            int m = P2_MOVES[k], face = m % 6;
+            if(redundant(face, prevFace)) continue;
+            int cp = cperm_move[cperm][m], ue = udedge_move[udedge][k], sp = sliceperm_move[sperm][k];
+            if(max(prune_cperm_sperm[cp * 24 + sp], prune_udedge_sperm[ue * 24 + sp]) >= depth) continue;
+            path_.push_back(m);
+            if(phase2(cp, ue, sp, depth - 1, face)) return true;
+            path_.pop_back();
+        }
+        return false;
+    }
+};
+
+void two_phase_prepare() {
+    call_once(two_phase_once, init_two_phase_tables);
+}
+
+bool two_phase_solve(const CubieCube &start, const TwoPhaseOptions &opt, vector<int> &solution, long long &nodes) {
+    two_phase_prepare();
+    TwoPhaseSearch search(start, opt);
+    return search.run(solution, nodes);
+}
+
+// ============================================================================
+// ANYTIME SEARCH
+// ============================================================================
+
+bool anytime_solve(const CubieCube &start_cube, int max_depth, const SearchBudget &budget, AnytimeResult &result) {
+    result = AnytimeResult();
+    pdb_bind_thread();
+    CoordCube start = to_coord(start_cube);
+    int bound = heuristic_pdb(start);
+    result.lower_bound = bound;
+    if(start == coord_solved) {
+        result.found = result.optimal = true;
+        return true;
+    }
+    
+    long long nodes = 0;
+    BudgetClock clock(budget, &nodes);
+    TranspositionTable *tt = thread_tt();
+    SearchCancel stop{nullptr, 0, search_abort, &clock};
+    while(bound <= max_depth) {
+        vector<int> path;
+        int nextBound = INT_MAX;
+        if(tt) tt->new_iteration();
+        clock.set_bound(bound);
+        SearchStats *st = search_stats;
+        long long iter_nodes = nodes;
+        double iter_start = clock.elapsed();
+        if(st) st->begin_iteration(bound);
+        bool found = ida_search_pdb(start, 0, bound, FSM_START, path, nodes, nextBound, &stop, tt);
+        if(st) st->end_iteration(nodes - iter_nodes, clock.elapsed() - iter_start);
+        if(found) {
+            result.found = result.optimal = true;
+            result.solution = path;
+            break;
+        }
+        if(clock.exhausted || aborted()) {
+            result.exhausted = true;
+            break;
+        }
+        if(nextBound == INT_MAX) break;
+        bound = result.lower_bound = nextBound;
+    }
+    if(tt) tt->flush_stats();
+    
+    // Out of budget: the best fast answer, which stops early once it meets
+    // the lower bound
+    if(result.exhausted && !aborted()) {
+        TwoPhaseOptions fallback;
+        fallback.target = result.lower_bound;
+        fallback.time_budget = budget.fallback_seconds;
+        if(two_phase_solve(start_cube, fallback, result.solution, result.fallback_nodes)) {
+            result.found = true;
+            result.optimal = (int)result.solution.size() <= result.lower_bound;
+        }
+    }
+    result.nodes = nodes;
+    return result.found;
+}
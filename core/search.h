@@ -0,0 +1,272 @@
+// core/search.h
+// The solvers: optimal IDA* over the PDB heuristic (single-threaded,
+// parallel, and meeting a stored backward frontier) and Kociemba's two-phase
+// search, plus the transposition table and move-pruning automaton they share.
+
+#pragma once
+
+#include "pdb.h"
+
+// ============================================================================
+// TRANSPOSITION TABLE
+// ============================================================================
+
+extern size_t tt_megabytes;    // --tt-mb; 0 disables the table
+
+struct TTStats {
+    long long probes = 0;
+    long long hits = 0;         // state found from this iteration
+    long long pruned = 0;       // ... and the revisit was cut
+    long long stores = 0;
+    long long replacements = 0; // a live entry of this iteration was overwritten
+};
+
+class TranspositionTable;
+
+void print_tt_stats();
+
+// ============================================================================
+// SEARCH STATISTICS
+// ============================================================================
+// Recorded only in builds with RUBIK_STATS (cmake -DRUBIK_STATS=ON), so the
+// default hot path carries no counters. IDA* records into search_stats when
+// the calling thread has set it; parallel workers fill their own copies, which
+// are merged after every iteration. Time per node is read from the TSC on x86
+// and from steady_clock (in ns) elsewhere.
+
+#ifdef RUBIK_STATS
+const bool STATS_BUILD = true;
+#else
+const bool STATS_BUILD = false;
+#endif
+
+const int STATS_MAX_DEPTH = 32;
+const int STATS_MAX_H = 32;
+
+struct IterationStats {
+    int bound = 0;
+    long long nodes = 0;
+    double seconds = 0;
+    array<long long,STATS_MAX_DEPTH> depth_nodes{};    // nodes visited at depth g
+    array<long long,STATS_MAX_DEPTH> depth_cutoffs{};  // ... and pruned by f > bound
+    array<long long,STATS_MAX_DEPTH> depth_h{};        // sum of their h
+    array<uint64_t,STATS_MAX_DEPTH> depth_ticks{};     // time from one node to the next
+
+    uint64_t ticks() const;
+};
+
+struct SearchStats {
+    vector<IterationStats> iterations;
+    IterationStats current;
+    array<long long,H_SOURCES> h_source{};
+    array<long long,STATS_MAX_H> h_values{};
+    uint64_t last_tick = 0;
+    int last_depth = 0;
+
+    void record_node(int g, int h, int source, bool cutoff) {
+        uint64_t now = stats_ticks();
+        current.depth_ticks[last_depth] += now - last_tick;
+        last_tick = now;
+        last_depth = min(g, STATS_MAX_DEPTH - 1);
+        current.depth_nodes[last_depth]++;
+        current.depth_cutoffs[last_depth] += cutoff;
+        current.depth_h[last_depth] += h;
+        h_source[source]++;
+        h_values[min(h, STATS_MAX_H - 1)]++;
+    }
+
+    void begin_iteration(int bound);
+    void flush();      // charge the time since the last node to it
+    void end_iteration(long long nodes, double seconds);
+    void merge(const SearchStats &worker);   // adds a worker's current iteration
+
+    static uint64_t stats_ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __builtin_ia32_rdtsc();
+#else
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+    static const char *tick_unit();
+
+    void print(ostream &out) const;
+    string json() const;
+};
+
+extern thread_local SearchStats *search_stats;
+
+// ============================================================================
+// MOVE PRUNING AUTOMATON
+// ============================================================================
+
+const int FSM_DEPTH = 4;
+const int FSM_START = 0;
+
+void init_move_fsm();
+
+// ============================================================================
+// IDA* WITH PDB
+// ============================================================================
+
+// Stops solves on this thread from outside, e.g. for a deadline or a cancel
+// request: once the flag is true, every solver returns as soon as it next
+// looks, with what it has (nothing, for the optimal searches)
+extern thread_local const atomic<bool> *search_abort;
+
+struct SearchProgress {
+    int bound = 0;             // the iteration under way; no solution is shorter
+    long long nodes = 0;
+    double seconds = 0;
+    double nodes_per_sec = 0;
+};
+
+// Limits for anytime_solve. Either limit may be 0 for none.
+struct SearchBudget {
+    double seconds = 0;
+    long long nodes = 0;
+    double fallback_seconds = 0.05;    // two-phase improvement time once IDA* gives up
+    function<void(const SearchProgress &)> progress;
+    double progress_interval = 1.0;    // seconds between progress calls
+};
+
+// Enforces a SearchBudget from inside the search. The clock is only read
+// every BUDGET_CHECK_INTERVAL polls, so a poll costs one decrement; the
+// interval shrinks to the nodes left, so a node limit is met exactly.
+const int BUDGET_CHECK_INTERVAL = 4096;
+
+class BudgetClock {
+public:
+    BudgetClock(const SearchBudget &budget, const long long *nodes);
+    
+    bool spent() {
+        if(--countdown > 0) return exhausted;
+        return check();
+    }
+    bool check();
+    void set_bound(int b);     // a new iteration; reports progress
+    double elapsed() const;
+    
+    bool exhausted = false;
+    
+private:
+    const SearchBudget &budget;
+    const long long *nodes;
+    chrono::steady_clock::time_point start;
+    double last_report = 0;
+    int countdown = BUDGET_CHECK_INTERVAL;
+    int bound = 0;
+    
+    void report(double seconds);
+    void rearm();
+};
+
+// Cooperative cancellation, polled before every node is counted and before
+// each child is searched: a parallel subtree gives up as soon as a solution
+// has been found in a task ordered before it, and any search once its abort
+// flag is set or its budget is spent
+struct SearchCancel {
+    const atomic<int> *best_task = nullptr;
+    int task = 0;
+    const atomic<bool> *abort = nullptr;
+    BudgetClock *budget = nullptr;
+    bool requested() const {
+        return (best_task && best_task->load(memory_order_relaxed) < task)
+            || (abort && abort->load(memory_order_relaxed))
+            || (budget && budget->spent());
+    }
+};
+
+// Bidirectional pathmax (--bpmx): prunes with child h values, which pays off
+// when the heuristic is inconsistent
+extern bool use_bpmx;
+
+bool ida_search_pdb(const CoordCube &node, int g, int bound, int fsm,
+                    vector<int> &path, long long &nodes, int &nextBound,
+                    const SearchCancel *cancel = nullptr, TranspositionTable *tt = nullptr);
+bool ida_star_solve_pdb(CubieCube start_cube, int max_depth, vector<int> &solution, long long &nodes);
+
+// ============================================================================
+// PARALLEL IDA*
+// ============================================================================
+
+struct ParallelOptions {
+    int threads = 1;
+    int split_depth = 3;
+    bool deterministic = false;   // return the lexicographically first solution
+};
+
+struct WorkerStats {
+    long long nodes = 0;
+    long long tasks = 0;
+    long long steals = 0;
+    double seconds = 0;
+};
+
+bool ida_star_solve_pdb_parallel(CubieCube start_cube, int max_depth, const ParallelOptions &opt,
+                                 vector<int> &solution, long long &nodes, vector<WorkerStats> &stats);
+
+// ============================================================================
+// MEET IN THE MIDDLE
+// ============================================================================
+// Every state within `depth` moves of solved is stored with its exact
+// distance, so the forward IDA* stops `depth` moves short of the bound and
+// finishes each branch with one lookup. Answers stay optimal; see the README
+// for what it saves next to the Korf edge tables.
+
+const int MITM_MAX_DEPTH = 7;
+
+struct MitmOptions {
+    int depth = 0;             // 0 = the deepest frontier that fits the cap
+    size_t megabytes = 1024;   // memory cap for the frontier table
+};
+
+struct MitmInfo {
+    int depth = 0;
+    size_t states = 0;
+    size_t bytes = 0;
+    double build_seconds = 0;
+};
+
+// Builds the frontier now instead of on the first solve. False if the cap
+// is too small for even depth 1. Safe to call from several threads.
+bool mitm_prepare(const MitmOptions &opt, MitmInfo *info = nullptr);
+
+bool mitm_solve(const CubieCube &start_cube, int max_depth, const MitmOptions &opt,
+                vector<int> &solution, long long &nodes);
+
+// ============================================================================
+// TWO-PHASE SOLVER
+// ============================================================================
+
+struct TwoPhaseOptions {
+    int target = 21;          // stop as soon as a solution this short is found
+    double time_budget = 1.0; // seconds
+    int max_phase1 = 12;
+    int max_phase2 = 18;
+};
+
+// Builds the phase tables (about 0.3 sec) now instead of on the first solve
+void two_phase_prepare();
+
+bool two_phase_solve(const CubieCube &start, const TwoPhaseOptions &opt, vector<int> &solution, long long &nodes);
+
+// ============================================================================
+// ANYTIME SEARCH
+// ============================================================================
+// Optimal IDA* under a SearchBudget. If the budget runs out first, the result
+// still carries a proven lower bound (the bound of the unfinished iteration)
+// and the best two-phase solution found in budget.fallback_seconds, which is
+// flagged optimal when it meets that bound. Single-threaded. Call
+// two_phase_prepare first to keep the table build out of the budget.
+
+struct AnytimeResult {
+    bool found = false;
+    bool optimal = false;      // the solution is proven shortest
+    bool exhausted = false;    // the budget ran out before IDA* finished
+    vector<int> solution;
+    int lower_bound = 0;       // no solution is shorter
+    long long nodes = 0;           // IDA*, never more than budget.nodes
+    long long fallback_nodes = 0;  // the two-phase fallback's, on top
+};
+
+bool anytime_solve(const CubieCube &start_cube, int max_depth, const SearchBudget &budget, AnytimeResult &result);
@@ -1,398 +1,1160 @@
 // rubiks_solver_pdb.cpp
 // Phase 6: IDA* with Pattern Database Heuristic
-// Compile: g++ -O2 -std=c++17 rubiks_solver_pdb.cpp -o rubiks_pdb.exe
+// Build: cmake -S . -B build && cmake --build build  (or see README.md)
 // Usage: rubiks_pdb.exe scramble 15 solve 20
 
-#include <bits/stdc++.h>
-using namespace std;
+#include "core/notation.h"
+#include "core/options.h"
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
 
 // ============================================================================
-// CUBIE REPRESENTATION
+// SOLVE CACHE
 // ============================================================================
+// Solved positions are remembered by canonical form: the smallest of the 96
+// cubes S * X * S^-1 and S * X^-1 * S^-1 over the 48 symmetries, so a position
+// shares one entry with its rotations, mirror images and inverse. "Smallest"
+// is CubeKey order, and the entry is keyed by that CubeKey. The least recently
+// used entry goes first when the cache is full. The stored solution belongs to
+// the canonical cube and is mapped back through the symmetry (reversed and
+// inverted for the inverse) on a hit.
 
-struct CubieCube {
-    array<uint8_t,8> cp;
-    array<uint8_t,8> co;
-    array<uint8_t,12> ep;
-    array<uint8_t,12> eo;
-    
-    CubieCube(){ 
-        for(int i=0;i<8;i++){cp[i]=i; co[i]=0;} 
-        for(int i=0;i<12;i++){ep[i]=i; eo[i]=0;} 
+CubieCube inverse_cube(const CubieCube &c) {
+    CubieCube r;
+    for(int i=0; i<8; i++) {
+        r.cp[c.cp[i]] = i;
+        r.co[c.cp[i]] = (3 - c.co[i]) % 3;
+    }
+    for(int i=0; i<12; i++) {
+        r.ep[c.ep[i]] = i;
+        r.eo[c.ep[i]] = c.eo[i];
+    }
+    return r;
+}
+
+struct CanonicalCube {
+    CubeKey key;
+    int sym = 0;
+    bool inverse = false;   // cube = S * X^-1 * S^-1 rather than S * X * S^-1
+};
+
+CanonicalCube canonicalize(const CubieCube &c) {
+    CanonicalCube best;
+    best.key = cube_key(c);
+    CubieCube inv = inverse_cube(c);
+    for(int s=0; s<N_SYM; s++) {
+        for(bool inverse : {false, true}) {
+            CubeKey conj = cube_key(sym_conjugate(s, inverse ? inv : c));
+            if(conj < best.key) {
+                best.key = conj;
+                best.sym = s;
+                best.inverse = inverse;
+            }
+        }
+    }
+    return best;
+}
+
+// Solution of X -> solution of its canonical cube
+vector<int> to_canonical_solution(const CanonicalCube &k, const vector<int> &solution) {
+    vector<int> out;
+    if(k.inverse) {
+        for(auto it = solution.rbegin(); it != solution.rend(); ++it) out.push_back(reverse_turn(*it));
+    } else {
+        out = solution;
+    }
+    for(int &m : out) m = sym_move[k.sym][m];
+    return out;
+}
+
+// Solution of the canonical cube -> solution of X
+vector<int> from_canonical_solution(const CanonicalCube &k, const vector<int> &solution) {
+    vector<int> out = solution;
+    for(int &m : out) m = sym_move[sym_inv[k.sym]][m];
+    if(k.inverse) {
+        reverse(out.begin(), out.end());
+        for(int &m : out) m = reverse_turn(m);
     }
+    return out;
+}
+
+class SolveCache {
+public:
+    struct Stats {
+        long long hits = 0;
+        long long misses = 0;
+        long long inserts = 0;
+        long long evictions = 0;
+        size_t entries = 0;
+    };
     
-    static CubieCube solved(){ return CubieCube(); }
+    explicit SolveCache(size_t capacity) : capacity(max<size_t>(1, capacity)) {}
     
-    bool is_solved() const {
-        for(int i=0;i<8;i++) if(cp[i]!=i || co[i]!=0) return false;
-        for(int i=0;i<12;i++) if(ep[i]!=i || eo[i]!=0) return false;
+    // need_optimal: only accept solutions found by the optimal search
+    bool lookup(const CubieCube &c, bool need_optimal, vector<int> &solution) {
+        CanonicalCube k = canonicalize(c);
+        lock_guard<mutex> guard(lock);
+        auto it = index.find(k.key);
+        if(it == index.end() || (need_optimal && !it->second->optimal)) {
+            counters.misses++;
+            return false;
+        }
+        lru.splice(lru.begin(), lru, it->second);
+        solution = from_canonical_solution(k, it->second->solution);
+        counters.hits++;
         return true;
     }
     
-    CubieCube operator*(const CubieCube &b) const {
-        CubieCube result;
-        for(int i=0; i<8; i++) {
-            result.cp[i] = cp[b.cp[i]];
-            result.co[i] = (co[b.cp[i]] + b.co[i]) % 3;
+    void insert(const CubieCube &c, bool optimal, const vector<int> &solution) {
+        CanonicalCube k = canonicalize(c);
+        vector<int> canon = to_canonical_solution(k, solution);
+        lock_guard<mutex> guard(lock);
+        auto it = index.find(k.key);
+        if(it != index.end()) {
+            Entry &e = *it->second;
+            // Keep the better answer: optimal beats suboptimal, then shorter wins
+            bool better = (optimal && !e.optimal)
+                || (optimal == e.optimal && canon.size() < e.solution.size());
+            if(better) {
+                e.optimal = optimal;
+                e.solution = move(canon);
+            }
+            lru.splice(lru.begin(), lru, it->second);
+            return;
+        }
+        lru.push_front(Entry{k.key, optimal, move(canon)});
+        index[k.key] = lru.begin();
+        counters.inserts++;
+        if(lru.size() > capacity) {
+            index.erase(lru.back().key);
+            lru.pop_back();
+            counters.evictions++;
+        }
+    }
+    
+    Stats stats() const {
+        lock_guard<mutex> guard(lock);
+        Stats s = counters;
+        s.entries = lru.size();
+        return s;
+    }
+    
+    // Text file, one entry per line: the state key, 'o' or 's' for optimal or
+    // suboptimal, then the solution moves. Files from before the key, which
+    // spell the cube out as cp co ep eo digit strings (edges in hex), still
+    // load. Lines whose solution does not solve their cube are skipped.
+    bool load(const string &filename) {
+        ifstream in(filename);
+        if(!in) return false;
+        string line;
+        int loaded = 0, skipped = 0;
+        while(getline(in, line)) {
+            if(line.empty() || line[0] == '#') continue;
+            istringstream fields(line);
+            string cp, co, ep, eo, kind;
+            fields >> cp;
+            bool keyed = cp.size() == KEY_DIGITS;
+            if(!keyed) fields >> co >> ep >> eo;
+            fields >> kind;
+            string rest, error;
+            getline(fields, rest);
+            CubieCube c;
+            vector<int> solution;
+            bool ok = (kind == "o" || kind == "s") && parse_moves(rest, solution, error);
+            if(keyed) ok = ok && parse_key(cp, c, error);
+            else ok = ok && cp.size() == 8 && co.size() == 8 && ep.size() == 12 && eo.size() == 12;
+            for(int i=0; ok && !keyed && i<8; i++) {
+                c.cp[i] = cp[i] - '0';
+                c.co[i] = co[i] - '0';
+                ok = c.cp[i] < 8 && c.co[i] < 3;
+            }
+            for(int i=0; ok && !keyed && i<12; i++) {
+                c.ep[i] = isdigit(ep[i]) ? ep[i] - '0' : ep[i] - 'a' + 10;
+                c.eo[i] = eo[i] - '0';
+                ok = c.ep[i] < 12 && c.eo[i] < 2;
+            }
+            if(ok) {
+                CubieCube check = c;
+                for(int m : solution) check = apply_move(check, m);
+                ok = check.is_solved();
+            }
+            if(!ok) {
+                skipped++;
+                continue;
+            }
+            insert(c, kind == "o", solution);
+            loaded++;
         }
-        for(int i=0; i<12; i++) {
-            result.ep[i] = ep[b.ep[i]];
-            result.eo[i] = (eo[b.ep[i]] + b.eo[i]) % 2;
+        lock_guard<mutex> guard(lock);
+        counters.inserts = 0;
+        counters.evictions = 0;
+        *log_out << "[OK] Loaded " << loaded << " cached solutions from " << filename;
+        if(skipped) *log_out << " (" << skipped << " bad lines skipped)";
+        *log_out << "\n";
+        return true;
+    }
+    
+    bool save(const string &filename) const {
+        ofstream out(filename);
+        if(!out) return false;
+        lock_guard<mutex> guard(lock);
+        out << "# rubiks_solver solve cache: key o|s solution\n";
+        // Least recent first, so loading the file rebuilds the same LRU order
+        for(auto it = lru.rbegin(); it != lru.rend(); ++it) {
+            const Entry &e = *it;
+            out << key_to_string(e.key) << " " << (e.optimal ? "o" : "s") << " " << seq_to_string(e.solution) << "\n";
         }
-        return result;
+        return (bool)out;
     }
+    
+private:
+    struct Entry {
+        CubeKey key;
+        bool optimal;
+        vector<int> solution;
+    };
+    
+    size_t capacity;
+    list<Entry> lru;    // most recently used first
+    unordered_map<CubeKey, list<Entry>::iterator> index;
+    Stats counters;
+    mutable mutex lock;
 };
 
+void print_cache_stats(const SolveCache &cache) {
+    SolveCache::Stats s = cache.stats();
+    *log_out << "[OK] Cache: " << s.hits << " hits, " << s.misses << " misses, "
+             << s.inserts << " inserts, " << s.evictions << " evictions, "
+             << s.entries << " entries\n";
+}
+
 // ============================================================================
-// MOVE TABLES
+// BATCH MODE
 // ============================================================================
+// One process loads the PDBs once and solves a stream of positions, one per
+// input line: either a move sequence in this solver's notation (applied to
+// the solved cube) or a 54-character facelet string. Solutions for facelet
+// input are printed in standard notation. Results stream out one line each,
+// as JSON or CSV, in input order or as they complete.
 
-CubieCube moveU() {
-    CubieCube c;
-    c.cp = {1, 2, 3, 0, 4, 5, 6, 7};
-    c.co = {0, 0, 0, 0, 0, 0, 0, 0};
-    c.ep = {1, 2, 3, 0, 4, 5, 6, 7, 8, 9, 10, 11};
-    c.eo = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-    return c;
-}
+struct BatchOptions : SolverOptions {
+    string input = "-";
+    string format = "json";
+    bool input_order = true;
+    int workers = 1;
+    int max_depth = 20;
+    SearchBudget budget;       // optimal mode: anytime search when either limit is set
+    SolveCache *cache = nullptr;
+    
+    bool budgeted() const { return !two_phase && !mitm && (budget.seconds > 0 || budget.nodes > 0); }
+};
 
-CubieCube moveR() {
-    CubieCube c;
-    c.cp = {3, 1, 2, 7, 0, 5, 6, 4};
-    c.co = {2, 0, 0, 1, 1, 0, 0, 2};
-    c.ep = {11, 1, 2, 3, 8, 5, 6, 7, 0, 9, 10, 4};
-    c.eo = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-    return c;
-}
+struct BatchResult {
+    long long id;
+    string input;
+    string error;
+    bool found = false;
+    bool cached = false;
+    vector<int> solution;
+    long long nodes = 0;
+    double seconds = 0;
+    string status;     // server only: also says why a solve stopped early
+    bool anytime = false;
+    bool optimal = false;
+    int lower_bound = 0;
+    long long fallback_nodes = 0;   // anytime: two-phase nodes, not in nodes
+};
 
-CubieCube moveF() {
-    CubieCube c;
-    c.cp = {4, 0, 2, 3, 5, 1, 6, 7};
-    c.co = {1, 2, 0, 0, 2, 1, 0, 0};
-    c.ep = {0, 8, 2, 3, 4, 9, 6, 7, 5, 1, 10, 11};
-    c.eo = {0, 1, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0};
-    return c;
+string json_escape(const string &s) {
+    string out;
+    for(char ch : s) {
+        if(ch == '"' || ch == '\\') out += '\\';
+        out += ch;
+    }
+    return out;
 }
 
-CubieCube moveD() {
-    CubieCube c;
-    c.cp = {0, 1, 2, 3, 7, 4, 5, 6};
-    c.co = {0, 0, 0, 0, 0, 0, 0, 0};
-    c.ep = {0, 1, 2, 3, 7, 4, 5, 6, 8, 9, 10, 11};
-    c.eo = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-    return c;
+// A CSV field in quotes, with embedded quotes doubled
+string csv_quote(const string &s) {
+    string out = "\"";
+    for(char ch : s) {
+        if(ch == '"') out += '"';
+        out += ch;
+    }
+    return out + "\"";
 }
 
-CubieCube moveL() {
-    CubieCube c;
-    c.cp = {0, 5, 1, 3, 4, 6, 2, 7};
-    c.co = {0, 1, 2, 0, 0, 2, 1, 0};
-    c.ep = {0, 1, 9, 3, 4, 5, 10, 7, 8, 6, 2, 11};
-    c.eo = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-    return c;
+string format_result(const BatchResult &r, const string &format) {
+    ostringstream out;
+    string sol = seq_to_string(r.solution);
+    if(format == "csv") {
+        string status = !r.error.empty() ? "error" : (r.found ? "solved" : "not_found");
+        out << r.id << "," << status << "," << (r.found ? (int)r.solution.size() : -1) << ","
+            << sol << "," << r.nodes << "," << r.seconds << ",";
+        if(!r.error.empty()) out << csv_quote(r.error);
+    } else {
+        out << "{\"id\":" << r.id << ",\"input\":\"" << json_escape(r.input) << "\"";
+        if(!r.status.empty()) out << ",\"status\":\"" << r.status << "\"";
+        if(!r.error.empty()) {
+            out << ",\"error\":\"" << json_escape(r.error) << "\"}";
+        } else {
+            out << ",\"solved\":" << (r.found ? "true" : "false");
+            if(r.found) out << ",\"length\":" << r.solution.size() << ",\"solution\":\"" << sol << "\"";
+            if(r.cached) out << ",\"cached\":true";
+            if(r.anytime) {
+                out << ",\"optimal\":" << (r.optimal ? "true" : "false") << ",\"lower_bound\":" << r.lower_bound
+                    << ",\"fallback_nodes\":" << r.fallback_nodes;
+            }
+            out << ",\"nodes\":" << r.nodes << ",\"seconds\":" << r.seconds << "}";
+        }
+    }
+    return out.str();
 }
 
-CubieCube moveB() {
+BatchResult solve_batch_line(long long id, const string &line, const BatchOptions &opt) {
+    BatchResult r;
+    r.id = id;
+    r.input = line;
+    
     CubieCube c;
-    c.cp = {0, 1, 6, 2, 4, 5, 7, 3};
-    c.co = {0, 0, 1, 2, 0, 0, 2, 1};
-    c.ep = {0, 1, 2, 10, 4, 5, 6, 11, 8, 9, 7, 3};
-    c.eo = {0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 1};
-    return c;
+    bool facelets;
+    if(!parse_position(line, c, facelets, r.error)) return r;
+    
+    auto t0 = chrono::steady_clock::now();
+    if(opt.cache && opt.cache->lookup(c, !opt.two_phase, r.solution)
+       && (opt.two_phase || (int)r.solution.size() <= opt.max_depth)) {
+        r.found = r.cached = true;
+    } else if(opt.budgeted()) {
+        AnytimeResult a;
+        r.found = anytime_solve(c, opt.max_depth, opt.budget, a);
+        r.anytime = true;
+        r.optimal = a.optimal;
+        r.lower_bound = a.lower_bound;
+        r.solution = a.solution;
+        r.nodes = a.nodes;
+        r.fallback_nodes = a.fallback_nodes;
+        if(r.found && opt.cache) opt.cache->insert(c, a.optimal, r.solution);
+    } else {
+        r.found = opt.two_phase ? two_phase_solve(c, opt.two_phase_opt, r.solution, r.nodes)
+            : opt.mitm ? mitm_solve(c, opt.max_depth, opt.mitm_opt, r.solution, r.nodes)
+            : ida_star_solve_pdb(c, opt.max_depth, r.solution, r.nodes);
+        if(r.found && opt.cache) opt.cache->insert(c, !opt.two_phase, r.solution);
+    }
+    r.seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    if(facelets) {
+        for(int &m : r.solution) m = reverse_turn(m);
+    }
+    return r;
 }
 
-CubieCube moveTables[6];
-void init_move_tables() {
-    moveTables[0] = moveU();
-    moveTables[1] = moveR();
-    moveTables[2] = moveF();
-    moveTables[3] = moveD();
-    moveTables[4] = moveL();
-    moveTables[5] = moveB();
+int run_batch(const BatchOptions &opt) {
+    ifstream file;
+    if(opt.input != "-") {
+        file.open(opt.input);
+        if(!file) {
+            cerr << "Error: could not open " << opt.input << "\n";
+            return 1;
+        }
+    }
+    istream &in = opt.input == "-" ? cin : file;
+    
+    mutex lock;
+    condition_variable work_ready, space_ready;
+    deque<pair<long long,string>> queue;
+    const size_t QUEUE_LIMIT = 4 * opt.workers;
+    bool eof = false;
+    
+    // Input-order output: finished results wait here until their turn
+    map<long long,string> pending;
+    long long next_to_print = 0;
+    mutex out_lock;
+    
+    if(opt.format == "csv") cout << "id,status,length,solution,nodes,seconds,error\n" << flush;
+    
+    auto emit = [&](const BatchResult &r) {
+        string line = format_result(r, opt.format);
+        lock_guard<mutex> guard(out_lock);
+        if(!opt.input_order) {
+            cout << line << "\n" << flush;
+            return;
+        }
+        pending[r.id] = line;
+        while(!pending.empty() && pending.begin()->first == next_to_print) {
+            cout << pending.begin()->second << "\n";
+            pending.erase(pending.begin());
+            next_to_print++;
+        }
+        cout << flush;
+    };
+    
+    auto worker = [&]() {
+        while(true) {
+            pair<long long,string> job;
+            {
+                unique_lock<mutex> guard(lock);
+                work_ready.wait(guard, [&]{ return !queue.empty() || eof; });
+                if(queue.empty()) return;
+                job = move(queue.front());
+                queue.pop_front();
+            }
+            space_ready.notify_one();
+            emit(solve_batch_line(job.first, job.second, opt));
+        }
+    };
+    
+    vector<thread> pool;
+    for(int i=0; i<opt.workers; i++) pool.emplace_back(worker);
+    
+    string line;
+    long long id = 0;
+    while(getline(in, line)) {
+        while(!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+        size_t start = line.find_first_not_of(' ');
+        if(start == string::npos || line[start] == '#') continue;
+        unique_lock<mutex> guard(lock);
+        space_ready.wait(guard, [&]{ return queue.size() < QUEUE_LIMIT; });
+        queue.emplace_back(id++, line.substr(start));
+        guard.unlock();
+        work_ready.notify_one();
+    }
+    {
+        lock_guard<mutex> guard(lock);
+        eof = true;
+    }
+    work_ready.notify_all();
+    for(auto &th : pool) th.join();
+    return 0;
 }
 
 // ============================================================================
-// ZOBRIST HASHING FOR TRANSPOSITION PRUNING (Phase 7)
+// SERVER MODE
 // ============================================================================
+// A resident solver: PDBs, move tables and the solve cache stay loaded, and
+// clients send requests over a Unix domain socket (--socket) or TCP on
+// 127.0.0.1 (--port), one line each:
+//
+//   [solve] [id=N] [deadline=S] [mode=M] [max-depth=D] [target=L] [budget=S]
+//           [time-limit=S] [node-limit=N] POSITION
+//   cancel N
+//   stats
+//   ping
+//   quit
+//
+// POSITION is anything batch mode accepts. Each solve gets exactly one JSON
+// line back when it finishes, formatted as in batch mode, with a status:
+// solved, not_found, error, timeout, cancelled or rejected. Results come in
+// completion order, so a client that pipelines requests matches them up by
+// id (default: the request's line number on its connection). After `quit`
+// the connection closes once the solves already sent have answered.
+//
+// Solves wait in one bounded queue for a fixed pool of workers. A full queue
+// rejects at once instead of blocking the connection, and so does a deadline
+// that the queue ahead, at the recent median solve time per worker, would
+// already use up. A watchdog thread sets the abort flag of every solve whose
+// deadline has passed, and `cancel` sets it by hand; the search polls the
+// flag at every node. Ctrl-C or SIGTERM stops accepting, cancels what is
+// left, and exits.
+
+#ifndef _WIN32
+
+struct ServerOptions {
+    string socket_path;
+    int port = 0;
+    size_t queue_limit = 64;
+    double deadline = 0;       // seconds from arrival; 0 = none
+    BatchOptions solve;        // mode, max depth, workers and cache
+};
+
+static volatile sig_atomic_t server_stopping = 0;
+
+static void on_stop_signal(int) { server_stopping = 1; }
+
+struct ServerConnection {
+    int fd;
+    mutex write_lock;
+    bool open = true;
 
-static uint64_t Z_CORNER_POS[8][8];
-static uint64_t Z_CORNER_ORI[8][3];
-static uint64_t Z_EDGE_POS[12][12];
-static uint64_t Z_EDGE_ORI[12][2];
+    explicit ServerConnection(int fd) : fd(fd) {}
+    // The client sees EOF once its reader and all its solves are done
+    ~ServerConnection() { close(fd); }
 
-void init_zobrist() {
-    mt19937_64 rng(0xC0FFEE1234ULL);
-    for(int i=0;i<8;i++){
-        for(int p=0;p<8;p++) Z_CORNER_POS[i][p]=rng();
-        for(int o=0;o<3;o++) Z_CORNER_ORI[i][o]=rng();
+    bool is_open() {
+        lock_guard<mutex> guard(write_lock);
+        return open;
     }
-    for(int i=0;i<12;i++){
-        for(int p=0;p<12;p++) Z_EDGE_POS[i][p]=rng();
-        for(int o=0;o<2;o++) Z_EDGE_ORI[i][o]=rng();
+
+    void send_line(const string &line) {
+        lock_guard<mutex> guard(write_lock);
+        string data = line + "\n";
+        for(size_t done = 0; open && done < data.size(); ) {
+            ssize_t n = send(fd, data.data() + done, data.size() - done, MSG_NOSIGNAL);
+            if(n <= 0) open = false;
+            else done += n;
+        }
     }
-}
+};
 
-inline uint64_t hash_cube(const CubieCube &c){
-    uint64_t h=0;
-    for(int i=0;i<8;i++){ h ^= Z_CORNER_POS[i][c.cp[i]]; h ^= Z_CORNER_ORI[i][c.co[i]]; }
-    for(int i=0;i<12;i++){ h ^= Z_EDGE_POS[i][c.ep[i]]; h ^= Z_EDGE_ORI[i][c.eo[i]]; }
-    return h;
-}
+struct ServerJob {
+    shared_ptr<ServerConnection> conn;
+    long long id = 0;
+    string position;
+    BatchOptions opt;
+    chrono::steady_clock::time_point received;
+    chrono::steady_clock::time_point deadline = chrono::steady_clock::time_point::max();
+    atomic<bool> stop{false};
+    atomic<bool> cancelled{false};   // stopped by request rather than by the deadline
+};
 
-// ============================================================================
-// MOVE APPLICATION
-// ============================================================================
+class SolveServer {
+public:
+    explicit SolveServer(const ServerOptions &opt) : opt(opt), started(chrono::steady_clock::now()) {}
 
-enum Move { U=0, R=1, F=2, D=3, L=4, B=5, 
-            Up=6, Rp=7, Fp=8, Dp=9, Lp=10, Bp=11, 
-            U2=12, R2=13, F2=14, D2=15, L2=16, B2=17 };
+    int run() {
+        int listen_fd = open_listener();
+        if(listen_fd < 0) return 1;
+        signal(SIGINT, on_stop_signal);
+        signal(SIGTERM, on_stop_signal);
+        signal(SIGPIPE, SIG_IGN);
 
-string move_names[] = {"U", "R", "F", "D", "L", "B",
-                       "U'", "R'", "F'", "D'", "L'", "B'",
-                       "U2", "R2", "F2", "D2", "L2", "B2"};
+        vector<thread> workers;
+        for(int i=0; i<opt.solve.workers; i++) workers.emplace_back([this]{ worker_loop(); });
+        thread watchdog([this]{ watchdog_loop(); });
+        vector<weak_ptr<ServerConnection>> connections;
 
-CubieCube apply_move(const CubieCube &cube, int move) {
-    int base = move % 6;
-    int count = 1;
-    if(move >= 6 && move < 12) count = 3;
-    else if(move >= 12) count = 2;
-    
-    CubieCube result = cube;
-    for(int i=0; i<count; i++) {
-        result = result * moveTables[base];
+        while(!server_stopping) {
+            pollfd p{listen_fd, POLLIN, 0};
+            if(poll(&p, 1, 200) <= 0) continue;
+            int fd = accept(listen_fd, nullptr, nullptr);
+            if(fd < 0) continue;
+            auto conn = make_shared<ServerConnection>(fd);
+            connections.erase(remove_if(connections.begin(), connections.end(),
+                [](const weak_ptr<ServerConnection> &c) { return c.expired(); }), connections.end());
+            connections.push_back(conn);
+            lock_guard<mutex> guard(lock);
+            readers++;
+            thread([this, conn]{
+                serve_connection(conn);
+                lock_guard<mutex> guard(lock);
+                readers--;
+                readers_done.notify_all();
+            }).detach();
+        }
+
+        *log_out << "Shutting down\n";
+        close(listen_fd);
+        if(!opt.socket_path.empty()) unlink(opt.socket_path.c_str());
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+            for(auto &job : queue) job->cancelled = job->stop = true;
+            for(auto &job : in_flight) job->cancelled = job->stop = true;
+        }
+        work_ready.notify_all();
+        for(auto &th : workers) th.join();
+        watchdog.join();
+        for(auto &c : connections) {
+            if(auto conn = c.lock()) shutdown(conn->fd, SHUT_RDWR);
+        }
+        unique_lock<mutex> guard(lock);
+        readers_done.wait(guard, [&]{ return readers == 0; });
+        return 0;
     }
-    return result;
-}
 
-// ============================================================================
-// PDB ENCODING
-// ============================================================================
+private:
+    ServerOptions opt;
+    chrono::steady_clock::time_point started;
 
-const int factorial[13] = {1, 1, 2, 6, 24, 120, 720, 5040, 40320, 362880, 3628800, 39916800, 479001600};
+    mutex lock;
+    condition_variable work_ready;
+    deque<shared_ptr<ServerJob>> queue;
+    vector<shared_ptr<ServerJob>> in_flight;
+    bool stopping = false;
+    int readers = 0;
+    condition_variable readers_done;
 
-int encode_permutation_8(const array<uint8_t,8> &perm) {
-    int index = 0;
-    for(int i=0; i<8; i++) {
-        int smaller = 0;
-        for(int j=i+1; j<8; j++) {
-            if(perm[j] < perm[i]) smaller++;
+    // Counters and the latest latencies, under lock
+    long long accepted = 0, rejected = 0, completed = 0, solved = 0;
+    long long timeouts = 0, cancels = 0, errors = 0;
+    long long total_nodes = 0;
+    double total_solve_seconds = 0;
+    static const size_t LATENCY_WINDOW = 4096;
+    vector<double> latencies;         // ring buffer, request arrival to result
+    vector<double> solve_times;       // same, time spent solving
+    size_t latency_next = 0;
+
+    int open_listener() {
+        int fd;
+        if(!opt.socket_path.empty()) {
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            if(opt.socket_path.size() >= sizeof(addr.sun_path)) {
+                cerr << "Error: socket path too long: " << opt.socket_path << "\n";
+                return -1;
+            }
+            strcpy(addr.sun_path, opt.socket_path.c_str());
+            unlink(opt.socket_path.c_str());
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if(fd < 0 || ::bind(fd, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 64) < 0) {
+                cerr << "Error: could not listen on " << opt.socket_path << ": " << strerror(errno) << "\n";
+                return -1;
+            }
+            *log_out << "[OK] Listening on " << opt.socket_path << "\n";
+        } else {
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(opt.port);
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            fd = socket(AF_INET, SOCK_STREAM, 0);
+            int yes = 1;
+            if(fd >= 0) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+            if(fd < 0 || ::bind(fd, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 64) < 0) {
+                cerr << "Error: could not listen on 127.0.0.1:" << opt.port << ": " << strerror(errno) << "\n";
+                return -1;
+            }
+            *log_out << "[OK] Listening on 127.0.0.1:" << opt.port << "\n";
         }
-        index += smaller * factorial[7-i];
+        *log_out << "[OK] " << opt.solve.workers << " workers, queue of " << opt.queue_limit << "\n";
+        return fd;
     }
-    return index;
-}
 
-int encode_orientation_corners(const array<uint8_t,8> &ori) {
-    int index = 0;
-    for(int i=0; i<7; i++) {
-        index = index * 3 + ori[i];
+    void serve_connection(shared_ptr<ServerConnection> conn) {
+        string buffer;
+        char chunk[4096];
+        long long line_no = 0;
+        while(true) {
+            size_t nl;
+            while((nl = buffer.find('\n')) != string::npos) {
+                string line = buffer.substr(0, nl);
+                buffer.erase(0, nl + 1);
+                while(!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+                size_t start = line.find_first_not_of(' ');
+                if(start == string::npos || line[start] == '#') continue;
+                if(!handle_line(conn, line.substr(start), line_no++)) return;
+            }
+            ssize_t n = recv(conn->fd, chunk, sizeof(chunk), 0);
+            if(n <= 0) return;
+            buffer.append(chunk, n);
+            if(buffer.size() > 65536 && buffer.find('\n') == string::npos) {
+                conn->send_line("{\"status\":\"error\",\"error\":\"line too long\"}");
+                return;
+            }
+        }
     }
-    return index;
-}
 
-int encode_edge_subset(const array<uint8_t,12> &ep, const array<uint8_t,12> &eo, 
-                       const array<int,6> &subset) {
-    array<uint8_t,6> perm;
-    array<uint8_t,6> ori;
-    
-    for(int i=0; i<6; i++) {
-        perm[i] = ep[subset[i]];
-        ori[i] = eo[subset[i]];
+    // False once the client asked to close the connection
+    bool handle_line(const shared_ptr<ServerConnection> &conn, const string &line, long long line_no) {
+        istringstream in(line);
+        string word;
+        in >> word;
+        if(word == "quit") return false;
+        if(word == "ping") {
+            conn->send_line("{\"pong\":true}");
+            return true;
+        }
+        if(word == "stats") {
+            conn->send_line(stats_json());
+            return true;
+        }
+        if(word == "cancel") {
+            long long id = -1;
+            in >> id;
+            conn->send_line("{\"id\":" + to_string(id) + ",\"cancel\":" + (cancel(conn, id) ? "true" : "false") + "}");
+            return true;
+        }
+
+        auto job = make_shared<ServerJob>();
+        job->conn = conn;
+        job->id = line_no;
+        job->opt = opt.solve;
+        job->received = chrono::steady_clock::now();
+        double deadline = opt.deadline;
+        string rest, error;
+        if(word != "solve") in.seekg(0);
+        // Options up front as key=value, then the position
+        while(in >> word) {
+            size_t eq = word.find('=');
+            if(!rest.empty() || eq == string::npos) {
+                rest += (rest.empty() ? "" : " ") + word;
+                continue;
+            }
+            string key = word.substr(0, eq), value = word.substr(eq + 1);
+            try {
+                if(key == "id") job->id = stoll(value);
+                else if(key == "deadline") deadline = stod(value);
+                else if(key == "max-depth") job->opt.max_depth = stoi(value);
+                else if(key == "target") job->opt.two_phase_opt.target = stoi(value);
+                else if(key == "budget") job->opt.two_phase_opt.time_budget = stod(value);
+                else if(key == "time-limit") job->opt.budget.seconds = stod(value);
+                else if(key == "node-limit") job->opt.budget.nodes = stoll(value);
+                else if(key == "mode" && (value == "optimal" || value == "two-phase" || value == "mitm")) {
+                    job->opt.two_phase = value == "two-phase";
+                    job->opt.mitm = value == "mitm";
+                }
+                else error = "unknown option '" + word + "'";
+            } catch(const exception &) {
+                error = "bad value in '" + word + "'";
+            }
+        }
+        job->position = rest;
+        if(deadline > 0) {
+            job->deadline = job->received + chrono::duration_cast<chrono::steady_clock::duration>(
+                chrono::duration<double>(deadline));
+        }
+        if(error.empty() && rest.empty()) error = "no position";
+        if(!error.empty()) {
+            BatchResult r;
+            r.id = job->id;
+            r.input = line;
+            r.error = error;
+            r.status = "error";
+            lock_guard<mutex> guard(lock);
+            errors++;
+            conn->send_line(format_result(r, "json"));
+            return true;
+        }
+        submit(job, deadline);
+        return true;
     }
-    
-    array<uint8_t,6> normalized;
-    for(int i=0; i<6; i++) {
-        int rank = 0;
-        for(int j=0; j<6; j++) {
-            if(perm[j] < perm[i]) rank++;
+
+    void submit(const shared_ptr<ServerJob> &job, double deadline) {
+        string reason;
+        {
+            lock_guard<mutex> guard(lock);
+            if(stopping) reason = "shutting down";
+            else if(queue.size() >= opt.queue_limit) reason = "queue full";
+            else if(deadline > 0 && queue.size() >= (size_t)opt.solve.workers
+                    && expected_wait() > deadline) reason = "deadline cannot be met";
+            if(reason.empty()) {
+                queue.push_back(job);
+                accepted++;
+            } else {
+                rejected++;
+            }
+        }
+        if(reason.empty()) {
+            work_ready.notify_one();
+            return;
         }
-        normalized[i] = rank;
+        BatchResult r;
+        r.id = job->id;
+        r.input = job->position;
+        r.error = reason;
+        r.status = "rejected";
+        job->conn->send_line(format_result(r, "json"));
     }
-    
-    int perm_idx = 0;
-    for(int i=0; i<6; i++) {
-        int smaller = 0;
-        for(int j=i+1; j<6; j++) {
-            if(normalized[j] < normalized[i]) smaller++;
+
+    // Time until a new request would start: the queue ahead of it, at the
+    // recent median solve time, spread over the workers. Called under lock.
+    double expected_wait() const {
+        vector<double> times = solve_times;
+        if(times.empty()) return 0;
+        nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+        return times[times.size() / 2] * (double)(queue.size() + 1) / opt.solve.workers;
+    }
+
+    bool cancel(const shared_ptr<ServerConnection> &conn, long long id) {
+        lock_guard<mutex> guard(lock);
+        bool found = false;
+        for(auto &job : queue) {
+            if(job->conn == conn && job->id == id) job->cancelled = job->stop = found = true;
+        }
+        for(auto &job : in_flight) {
+            if(job->conn == conn && job->id == id) job->cancelled = job->stop = found = true;
         }
-        perm_idx += smaller * factorial[5-i];
+        return found;
     }
-    
-    int ori_idx = 0;
-    for(int i=0; i<5; i++) {
-        ori_idx = ori_idx * 2 + ori[i];
+
+    void worker_loop() {
+        while(true) {
+            shared_ptr<ServerJob> job;
+            {
+                unique_lock<mutex> guard(lock);
+                work_ready.wait(guard, [&]{ return !queue.empty() || stopping; });
+                if(queue.empty()) return;
+                job = queue.front();
+                queue.pop_front();
+                in_flight.push_back(job);
+            }
+            if(chrono::steady_clock::now() >= job->deadline) job->stop = true;
+            if(!job->conn->is_open()) job->cancelled = job->stop = true;   // nobody to answer
+
+            BatchResult r;
+            if(job->stop) {
+                r.id = job->id;
+                r.input = job->position;
+            } else {
+                search_abort = &job->stop;
+                r = solve_batch_line(job->id, job->position, job->opt);
+                search_abort = nullptr;
+            }
+            r.status = !r.error.empty() ? "error" : r.found ? "solved"
+                : job->cancelled ? "cancelled" : job->stop ? "timeout" : "not_found";
+            finish(job, r);
+            job->conn->send_line(format_result(r, "json"));
+        }
     }
-    
-    return perm_idx * 32 + ori_idx;
-}
 
-// ============================================================================
-// PDB LOADING
-// ============================================================================
+    void finish(const shared_ptr<ServerJob> &job, const BatchResult &r) {
+        double latency = chrono::duration<double>(chrono::steady_clock::now() - job->received).count();
+        lock_guard<mutex> guard(lock);
+        in_flight.erase(find(in_flight.begin(), in_flight.end(), job));
+        completed++;
+        if(r.status == "solved") solved++;
+        else if(r.status == "timeout") timeouts++;
+        else if(r.status == "cancelled") cancels++;
+        else if(r.status == "error") errors++;
+        total_nodes += r.nodes + r.fallback_nodes;
+        total_solve_seconds += r.seconds;
+        if(latencies.size() < LATENCY_WINDOW) {
+            latencies.push_back(latency);
+            solve_times.push_back(r.seconds);
+        } else {
+            latencies[latency_next] = latency;
+            solve_times[latency_next] = r.seconds;
+            latency_next = (latency_next + 1) % LATENCY_WINDOW;
+        }
+    }
 
-vector<uint8_t> pdb_corners;
-vector<uint8_t> pdb_edges_a;
-vector<uint8_t> pdb_edges_b;
-array<int,6> subset_a = {0, 1, 2, 3, 4, 5};
-array<int,6> subset_b = {6, 7, 8, 9, 10, 11};
+    void watchdog_loop() {
+        while(true) {
+            {
+                lock_guard<mutex> guard(lock);
+                if(stopping) return;
+                auto now = chrono::steady_clock::now();
+                for(auto &job : in_flight) if(now >= job->deadline) job->stop = true;
+                for(auto &job : queue) if(now >= job->deadline) job->stop = true;
+            }
+            this_thread::sleep_for(chrono::milliseconds(5));
+        }
+    }
 
-bool load_pdb(const string &filename, vector<uint8_t> &pdb, int expected_size) {
-    ifstream in(filename, ios::binary);
-    if(!in) {
-        cout << "Warning: Could not load " << filename << "\n";
-        return false;
+    string stats_json() {
+        lock_guard<mutex> guard(lock);
+        vector<double> sorted = latencies;
+        sort(sorted.begin(), sorted.end());
+        auto percentile = [&](double p) {
+            if(sorted.empty()) return 0.0;
+            size_t rank = (size_t)ceil(p / 100.0 * sorted.size());
+            return sorted[min(sorted.size(), max<size_t>(rank, 1)) - 1];
+        };
+        ostringstream out;
+        out << "{\"queue\":" << queue.size() << ",\"queue_limit\":" << opt.queue_limit
+            << ",\"in_flight\":" << in_flight.size() << ",\"workers\":" << opt.solve.workers
+            << ",\"accepted\":" << accepted << ",\"rejected\":" << rejected << ",\"completed\":" << completed
+            << ",\"solved\":" << solved << ",\"timeouts\":" << timeouts << ",\"cancelled\":" << cancels
+            << ",\"errors\":" << errors << ",\"p50_seconds\":" << percentile(50)
+            << ",\"p99_seconds\":" << percentile(99) << ",\"nodes_per_sec\":"
+            << (total_solve_seconds > 0 ? total_nodes / total_solve_seconds : 0)
+            << ",\"uptime_seconds\":" << chrono::duration<double>(chrono::steady_clock::now() - started).count()
+            << "}";
+        return out.str();
     }
-    
-    pdb.resize(expected_size);
-    in.read(reinterpret_cast<char*>(pdb.data()), expected_size);
-    in.close();
-    
-    cout << "[OK] Loaded " << filename << " (" << (expected_size / 1024.0) << " KB)\n";
-    return true;
+};
+
+int run_server(const ServerOptions &opt) {
+    SolveServer server(opt);
+    return server.run();
 }
 
-void load_pdbs() {
-    cout << "Loading Pattern Databases...\n";
-    bool corners_loaded = load_pdb("pdbs/corners.bin", pdb_corners, 88179840);
-    load_pdb("pdbs/edges_a.bin", pdb_edges_a, 23040);
-    load_pdb("pdbs/edges_b.bin", pdb_edges_b, 23040);
-    if(corners_loaded) {
-        cout << "[OK] All PDBs loaded successfully\n";
-    } else {
-        cout << "[INFO] Running with edge PDBs only\n";
-    }
+#else
+
+int run_server(const ServerOptions &) {
+    cerr << "Error: serve needs POSIX sockets and is not available on Windows\n";
+    return 1;
 }
 
+#endif
+
 // ============================================================================
-// PDB HEURISTIC
+// SELF CHECK
 // ============================================================================
+// --self-check: the fast paths against the plain reference code they replace.
+// The ranking comparisons are exhaustive, since a single wrong index would
+// silently read the wrong PDB entry.
 
-int heuristic_pdb(const CubieCube &c) {
-    int h = 0;
-    
-    // Corner PDB
-    if(!pdb_corners.empty()) {
-        int idx_c = encode_permutation_8(c.cp) * 2187 + encode_orientation_corners(c.co);
-        if(idx_c >= 0 && idx_c < (int)pdb_corners.size()) {
-            h = max(h, (int)pdb_corners[idx_c]);
-        }
+// The nested-loop Lehmer code: count the smaller values to the right
+int reference_lehmer(const uint8_t *values, int k) {
+    int index = 0;
+    for(int i=0; i<k; i++) {
+        int smaller = 0;
+        for(int j=i+1; j<k; j++) if(values[j] < values[i]) smaller++;
+        index += smaller * factorial[k-1-i];
     }
+    return index;
+}
+
+bool rank_self_check() {
+    long long failures = 0;
     
-    // Edge PDB A
-    if(!pdb_edges_a.empty()) {
-        int idx_a = encode_edge_subset(c.ep, c.eo, subset_a);
-        if(idx_a >= 0 && idx_a < (int)pdb_edges_a.size()) {
-            h = max(h, (int)pdb_edges_a[idx_a]);
-        }
+    // Every index unranks to a permutation that follows the previous one in
+    // lexicographic order, and ranks back to the same index both ways
+    array<uint8_t,8> perm, prev = {};
+    for(int idx=0; idx<N_CPERM; idx++) {
+        unrank_perm8(idx, perm.data());
+        unsigned used = 0;
+        for(int i=0; i<8; i++) used |= 1u << perm[i];
+        if(used != 0xFF || rank_perm8(perm.data()) != idx || reference_lehmer(perm.data(), 8) != idx
+           || (idx > 0 && !(prev < perm))) failures++;
+        prev = perm;
     }
+    cout << (failures ? "[FAIL] " : "[OK] ") << "rank_perm8: " << N_CPERM
+         << " permutations, " << failures << " mismatches\n";
+    bool ok = failures == 0;
     
-    // Edge PDB B
-    if(!pdb_edges_b.empty()) {
-        int idx_b = encode_edge_subset(c.ep, c.eo, subset_b);
-        if(idx_b >= 0 && idx_b < (int)pdb_edges_b.size()) {
-            h = max(h, (int)pdb_edges_b[idx_b]);
+    // nPk in lexicographic order: each index unranks to the successor of the
+    // previous tuple, and the reference partial Lehmer code agrees
+    for(int k : {6, 7}) {
+        failures = 0;
+        long long count = 1;
+        for(int i=0; i<k; i++) count *= 12 - i;
+        uint8_t prev[12] = {0}, pos[12];
+        for(long long idx=0; idx<count; idx++) {
+            unrank_partial(idx, k, 12, pos);
+            long long ref = 0;
+            unsigned used = 0;
+            for(int i=0; i<k; i++) {
+                int smaller = 0;
+                for(int j=0; j<i; j++) if(pos[j] < pos[i]) smaller++;
+                ref = ref * (12 - i) + pos[i] - smaller;
+                if(pos[i] >= 12 || (used >> pos[i] & 1)) failures++;
+                used |= 1u << pos[i];
+            }
+            if(rank_partial(pos, k, 12) != idx || ref != idx) failures++;
+            if(idx > 0 && !lexicographical_compare(prev, prev + k, pos, pos + k)) failures++;
+            if(k == 6 && rank_relative(pos, 6) != reference_lehmer(pos, 6)) failures++;
+            copy(pos, pos + k, prev);
         }
+        cout << (failures ? "[FAIL] " : "[OK] ") << "rank_partial 12P" << k
+             << (k == 6 ? " and rank_relative: " : ": ") << count << " tuples, "
+             << failures << " mismatches\n";
+        ok = ok && failures == 0;
     }
-    
-    // Fallback: simple heuristic if PDBs not loaded
-    if(h == 0) {
-        int wrong = 0;
-        for(int i=0; i<12; i++) if(c.ep[i] != i || c.eo[i] != 0) wrong++;
-        h = (wrong + 3) / 4;
+    return ok;
+}
+
+// The inverse-cube Korf indices behind --dual, taken from slot contents,
+// against the same lookups on an inverse built cubie by cubie and checked to
+// multiply back to solved
+bool inverse_self_check() {
+    mt19937 rng(2024);
+    EdgePdb tables[] = {{{}, 6, 0}, {{}, 6, 6}, {{}, 7, 0}, {{}, 7, 5}};
+    int failures = 0;
+    const int trials = 100000;
+    for(int t=0; t<trials; t++) {
+        CubieCube c = random_cube(rng), inv = inverse_cube(c);
+        if(!(c * inv).is_solved()) failures++;
+        CoordCube coord = to_coord(c), inv_coord = to_coord(inv);
+        for(const EdgePdb &pdb : tables) {
+            for(int s : {0, SYM_URF3, 2 * SYM_URF3}) {
+                if(korf_dual_index(coord, pdb, s) != korf_index(inv_coord, pdb, s)) failures++;
+            }
+        }
     }
-    
-    return h;
+    cout << (failures ? "[FAIL] " : "[OK] ") << "--dual Korf indices: " << trials << " random cubes, "
+         << failures << " mismatches\n";
+    return failures == 0;
 }
 
-// ============================================================================
-// IDA* WITH PDB + PHASE 7 OPTIMIZATIONS
-// ============================================================================
+// CubeKey against the cubie arrays: pack/unpack and text round trips, and
+// key order matching lexicographic cube order
+bool key_self_check() {
+    mt19937 rng(77);
+    int failures = 0;
+    const int trials = 100000;
+    CubieCube prev = CubieCube::solved();
+    for(int t=0; t<trials; t++) {
+        CubieCube c = random_cube(rng), parsed;
+        CubeKey k = cube_key(c);
+        string error;
+        bool lex_less = tie(prev.cp, prev.co, prev.ep, prev.eo) < tie(c.cp, c.co, c.ep, c.eo);
+        if(!same_cube(key_cube(k), c) || !parse_key(key_to_string(k), parsed, error) || !same_cube(parsed, c)
+           || (cube_key(prev) < k) != lex_less)
+            failures++;
+        prev = c;
+    }
+    cout << (failures ? "[FAIL] " : "[OK] ") << "CubeKey: " << trials << " random cubes, "
+         << failures << " mismatches\n";
+    return failures == 0;
+}
 
-static const int FACE_AXIS[6] = {0,1,2,0,1,2}; // U/D, R/L, F/B
+// The solve cache through canonicalize: each random cube's canonical form is
+// solved with two-phase and stored, then every one of its 96 symmetry and
+// inverse variants must share that entry and get back a solution that
+// solves it
+bool cache_self_check() {
+    mt19937 rng(96);
+    two_phase_prepare();
+    int failures = 0;
+    const int trials = 20;
+    for(int t=0; t<trials; t++) {
+        CubieCube c = random_cube(rng), inv = inverse_cube(c);
+        CanonicalCube k = canonicalize(c);
+        CubieCube canon = key_cube(k.key);
+        TwoPhaseOptions opt;
+        opt.target = 30;    // any solution will do
+        vector<int> solution;
+        long long nodes;
+        SolveCache cache(1);
+        if(!two_phase_solve(canon, opt, solution, nodes)) {
+            failures++;
+            continue;
+        }
+        cache.insert(canon, false, solution);
+        for(int s=0; s<N_SYM; s++) {
+            for(bool inverse : {false, true}) {
+                CubieCube variant = sym_conjugate(s, inverse ? inv : c);
+                vector<int> found;
+                if(canonicalize(variant).key != k.key || !cache.lookup(variant, false, found)) {
+                    failures++;
+                    continue;
+                }
+                for(int m : found) variant = apply_move(variant, m);
+                if(!variant.is_solved()) failures++;
+            }
+        }
+    }
+    cout << (failures ? "[FAIL] " : "[OK] ") << "solve cache: " << trials << " random cubes x "
+         << 2 * N_SYM << " variants, " << failures << " mismatches\n";
+    return failures == 0;
+}
 
-bool ida_search_pdb(const CubieCube &node, int g, int bound, int prevFace,
-                    vector<int> &path, long long &nodes, int &nextBound) {
-    nodes++;
-    
-    int h = heuristic_pdb(node);
-    int f = g + h;
-    
-    if(f > bound) {
-        nextBound = min(nextBound, f);
-        return false;
+// Meet in the middle with two frontier radii: state counts must match the
+// known sphere sizes and both must find the same verified lengths
+bool mitm_self_check() {
+    const int trials = 200;
+    vector<CubieCube> cubes;
+    for(int t=0; t<trials; t++) {
+        CubieCube c = CubieCube::solved();
+        scramble_cube(c, 1 + t % 8, 5000 + t);
+        cubes.push_back(c);
     }
-    if(node.is_solved()) return true;
-    
-    for(int m=0; m<18; m++) {
-        int face = m % 6;
-        if(face == prevFace) continue;
-        if(prevFace != -1 && FACE_AXIS[face] == FACE_AXIS[prevFace]) continue;
-        
-        path.push_back(m);
-        CubieCube next = apply_move(node, m);
-        if(ida_search_pdb(next, g+1, bound, face, path, nodes, nextBound))
-            return true;
-        path.pop_back();
+    const long long expected[] = {0, 0, 0, 3502, 0, 621649};
+    int failures = 0;
+    vector<int> lengths[2];
+    for(int k=0; k<2; k++) {
+        MitmOptions opt;
+        opt.depth = k == 0 ? 5 : 3;
+        MitmInfo info;
+        if(!mitm_prepare(opt, &info) || (long long)info.states != expected[opt.depth]) failures++;
+        for(const CubieCube &c : cubes) {
+            vector<int> solution;
+            long long nodes;
+            bool found = mitm_solve(c, 8, opt, solution, nodes);
+            CubieCube check = c;
+            for(int m : solution) check = apply_move(check, m);
+            if(!found || !check.is_solved()) failures++;
+            lengths[k].push_back(found ? (int)solution.size() : -1);
+        }
     }
-    return false;
+    if(lengths[0] != lengths[1]) failures++;
+    cout << (failures ? "[FAIL] " : "[OK] ") << "mitm_solve: " << trials << " scrambles at frontier depths 5 and 3, "
+         << failures << " mismatches\n";
+    return failures == 0;
 }
 
-bool ida_star_solve_pdb(CubieCube start, int max_depth, vector<int> &solution, long long &nodes) {
-    nodes = 0;
-    int bound = heuristic_pdb(start);
-    if(start.is_solved()) { solution.clear(); return true; }
-    
-    for(int iter=0; iter<50; iter++) {
-        vector<int> path;
-        int nextBound = INT_MAX;
-        if(ida_search_pdb(start, 0, bound, -1, path, nodes, nextBound)) {
-            solution = path;
-            return true;
+// 2-bit corner entries: packing keeps every residue and the unseen marker,
+// and a child's depth comes back from its parent's for every possible move
+bool mod3_self_check() {
+    mt19937 rng(33);
+    int failures = 0;
+    vector<uint8_t> depths(100003);
+    for(uint8_t &d : depths) d = rng() % 16 == 0 ? 255 : rng() % 21;
+    PdbData packed;
+    packed.owned = pack_mod3(depths);
+    packed.data = packed.owned.data();
+    packed.bytes = packed.owned.size();
+    packed.node_data.fill(packed.data);
+    for(size_t i=0; i<depths.size(); i++) {
+        if(pdb_mod3(packed, i) != (depths[i] == 255 ? 3 : depths[i] % 3)) failures++;
+    }
+    for(int parent=0; parent<=20; parent++) {
+        for(int child=max(parent - 1, 0); child<=parent + 1; child++) {
+            if(mod3_child_depth(parent, child % 3) != child) failures++;
         }
-        if(nextBound == INT_MAX || nextBound > max_depth) return false;
-        bound = nextBound;
     }
-    return false;
+    cout << (failures ? "[FAIL] " : "[OK] ") << "depth mod 3: " << depths.size() << " packed entries, "
+         << failures << " mismatches\n";
+    return failures == 0;
 }
 
-// ============================================================================
-// SCRAMBLE
-// ============================================================================
-
-vector<int> scramble_cube(CubieCube &c, int num_moves) {
-    vector<int> seq;
-    mt19937 rng((unsigned)chrono::high_resolution_clock::now().time_since_epoch().count());
-    uniform_int_distribution<int> dist(0, 17);
-    
-    for(int i=0; i<num_moves; i++) {
-        int m = dist(rng);
-        c = apply_move(c, m);
-        seq.push_back(m);
+// Starved of nodes, anytime_solve must stay within the limit and still
+// return a valid solution and a lower bound no larger than the optimal
+// length; unlimited, it is optimal.
+bool anytime_self_check() {
+    const int trials = 60;
+    two_phase_prepare();
+    int failures = 0, exhausted = 0;
+    for(int t=0; t<trials; t++) {
+        CubieCube c = CubieCube::solved();
+        scramble_cube(c, 1 + t % 5, 7000 + t);
+        vector<int> optimal;
+        long long nodes;
+        ida_star_solve_pdb(c, 20, optimal, nodes);
+        for(long long limit : {200LL, 0LL}) {
+            SearchBudget budget;
+            budget.nodes = limit;
+            budget.fallback_seconds = 0;
+            AnytimeResult r;
+            bool found = anytime_solve(c, 20, budget, r);
+            CubieCube check = c;
+            for(int m : r.solution) check = apply_move(check, m);
+            if(!found || !check.is_solved() || r.lower_bound > (int)optimal.size()
+               || (r.optimal && r.solution.size() != optimal.size()) || (limit == 0 && !r.optimal)
+               || (limit > 0 && r.nodes > limit))
+                failures++;
+            exhausted += r.exhausted;
+        }
     }
-    return seq;
+    cout << (failures ? "[FAIL] " : "[OK] ") << "anytime_solve: " << trials << " scrambles, "
+         << exhausted << " out of budget, " << failures << " mismatches\n";
+    return failures == 0;
+}
+
+bool run_self_check() {
+    cout << "Packed cube multiply: " << packed_impl << "\n";
+    bool ok = packed_self_check();
+    ok = rank_self_check() && ok;
+    ok = inverse_self_check() && ok;
+    ok = key_self_check() && ok;
+    ok = cache_self_check() && ok;
+    ok = mitm_self_check() && ok;
+    ok = anytime_self_check() && ok;
+    ok = mod3_self_check() && ok;
+    cout << (ok ? "[OK] Self-check passed\n" : "[FAIL] Self-check failed\n");
+    return ok;
 }
 
 // ============================================================================
 // MAIN
 // ============================================================================
 
-string seq_to_string(const vector<int> &seq) {
-    string s;
-    for(size_t i=0; i<seq.size(); i++) {
-        if(i) s += " ";
-        s += move_names[seq[i]];
-    }
-    return s;
-}
-
 int main(int argc, char **argv) {
-    init_move_tables();
-    init_zobrist();
-    load_pdbs();
+    init_coord_tables();
+    init_sym_tables();
+    init_packed_cube();
+    init_move_fsm();
     
     int scramble_moves = 15;
+    unsigned seed = (unsigned)chrono::high_resolution_clock::now().time_since_epoch().count();
     int depth_limit = 20;
     bool do_solve = false;
+    bool do_self_check = false;
+    bool do_batch = false;
+    bool do_serve = false;
+    ServerOptions server;
+    BatchOptions batch;     // also holds the shared solver options
+    size_t cache_entries = 0;
+    string cache_file;
+    bool show_stats = false;
+    string stats_json;
+    bool show_progress = false;
     
     for(int i=1; i<argc; i++) {
         string arg = argv[i];
@@ -401,28 +1163,188 @@ int main(int argc, char **argv) {
         } else if(arg == "solve" && i+1 < argc) {
             depth_limit = stoi(argv[++i]);
             do_solve = true;
+        } else if(parse_solver_option(argc, argv, i, batch)) {
+            continue;
+        } else if(arg == "batch") {
+            do_batch = true;
+        } else if(arg == "serve") {
+            do_serve = true;
+        } else if(arg == "--socket" && i+1 < argc) {
+            server.socket_path = argv[++i];
+        } else if(arg == "--port" && i+1 < argc) {
+            server.port = stoi(argv[++i]);
+        } else if(arg == "--queue" && i+1 < argc) {
+            server.queue_limit = max(1, stoi(argv[++i]));
+        } else if(arg == "--deadline" && i+1 < argc) {
+            server.deadline = max(0.0, stod(argv[++i]));
+        } else if(arg == "--self-check") {
+            do_self_check = true;
+        } else if(arg == "--input" && i+1 < argc) {
+            batch.input = argv[++i];
+        } else if(arg == "--format" && i+1 < argc) {
+            batch.format = argv[++i];
+        } else if(arg == "--order" && i+1 < argc) {
+            batch.input_order = string(argv[++i]) != "completion";
+        } else if(arg == "--workers" && i+1 < argc) {
+            batch.workers = max(1, stoi(argv[++i]));
+        } else if(arg == "--max-depth" && i+1 < argc) {
+            batch.max_depth = stoi(argv[++i]);
+        } else if(arg == "--time-limit" && i+1 < argc) {
+            batch.budget.seconds = max(0.0, stod(argv[++i]));
+        } else if(arg == "--node-limit" && i+1 < argc) {
+            batch.budget.nodes = max(0LL, stoll(argv[++i]));
+        } else if(arg == "--progress") {
+            show_progress = true;
+        } else if(arg == "--cache" && i+1 < argc) {
+            cache_entries = max(0, stoi(argv[++i]));
+        } else if(arg == "--cache-file" && i+1 < argc) {
+            cache_file = argv[++i];
+        } else if(arg == "--seed" && i+1 < argc) {
+            seed = (unsigned)stoul(argv[++i]);
+        } else if(arg == "--stats") {
+            show_stats = true;
+        } else if(arg == "--stats-json" && i+1 < argc) {
+            stats_json = argv[++i];
+            show_stats = true;
+        }
+    }
+    if(!cache_file.empty() && cache_entries == 0) cache_entries = 100000;
+    if(show_stats && !STATS_BUILD) {
+        cout << "Warning: Built without RUBIK_STATS, --stats ignored (configure with -DRUBIK_STATS=ON)\n";
+        show_stats = false;
+    }
+    
+    if(do_self_check) {
+        return run_self_check() ? 0 : 1;
+    }
+    
+    if(do_batch || do_serve) log_out = &cerr;
+    unique_ptr<SolveCache> cache;
+    if(cache_entries > 0) {
+        cache.reset(new SolveCache(cache_entries));
+        if(!cache_file.empty() && ifstream(cache_file).good()) cache->load(cache_file);
+    }
+    auto save_cache = [&]() {
+        if(!cache) return;
+        print_cache_stats(*cache);
+        if(!cache_file.empty() && !cache->save(cache_file)) {
+            *log_out << "Warning: Could not write " << cache_file << "\n";
+        }
+    };
+    
+    if(do_serve) {
+        if(server.socket_path.empty() && server.port <= 0) {
+            cerr << "Error: serve needs --socket PATH or --port N\n";
+            return 1;
+        }
+        load_pdbs();
+        two_phase_prepare();   // requests may ask for two-phase or a budget
+        if(batch.mitm && !mitm_prepare(batch.mitm_opt)) {
+            *log_out << "Warning: --mitm-mb " << batch.mitm_opt.megabytes << " is too small for a frontier, using plain IDA*\n";
+        }
+        batch.cache = cache.get();
+        server.solve = batch;
+        int status = run_server(server);
+        save_cache();
+        return status;
+    }
+    
+    if(do_batch) {
+        load_pdbs();
+        if(batch.budgeted()) two_phase_prepare();
+        if(batch.mitm && !mitm_prepare(batch.mitm_opt)) {
+            *log_out << "Warning: --mitm-mb " << batch.mitm_opt.megabytes << " is too small for a frontier, using plain IDA*\n";
         }
+        batch.cache = cache.get();
+        int status = run_batch(batch);
+        save_cache();
+        if(tt_megabytes > 0) print_tt_stats();
+        return status;
+    }
+    
+    load_pdbs();
+    if(batch.mitm && do_solve && !mitm_prepare(batch.mitm_opt)) {
+        cout << "Warning: --mitm-mb " << batch.mitm_opt.megabytes << " is too small for a frontier, using plain IDA*\n";
     }
     
     if(do_solve) {
         CubieCube c = CubieCube::solved();
-        auto seq = scramble_cube(c, scramble_moves);
+        auto seq = scramble_cube(c, scramble_moves, seed);
         
         cout << "\n=== Phase 6: PDB-Enhanced Solver ===\n";
-        cout << "Scramble (" << scramble_moves << " moves): " << seq_to_string(seq) << "\n";
-        cout << "Searching with IDA* + PDBs (max depth " << depth_limit << ")...\n";
+        cout << "Scramble (" << scramble_moves << " moves, seed " << seed << "): " << seq_to_string(seq) << "\n";
+        if(batch.two_phase) {
+            cout << "Searching with two-phase (target " << batch.two_phase_opt.target << ", budget "
+                 << batch.two_phase_opt.time_budget << " sec)...\n";
+        } else if(batch.mitm) {
+            cout << "Searching with IDA* + PDBs to the frontier (max depth " << depth_limit << ")...\n";
+        } else {
+            cout << "Searching with IDA* + PDBs (max depth " << depth_limit << ")...\n";
+        }
+        if(batch.budgeted()) {
+            two_phase_prepare();
+            if(batch.par.threads > 1) cout << "Warning: --time-limit and --node-limit search on one thread\n";
+            if(show_progress) {
+                batch.budget.progress = [](const SearchProgress &p) {
+                    cout << "[INFO] Bound " << p.bound << ": " << p.nodes << " nodes, "
+                         << (long long)p.nodes_per_sec << " nodes/sec, " << p.seconds << " sec\n" << flush;
+                };
+            }
+        } else if(batch.budget.seconds > 0 || batch.budget.nodes > 0) {
+            cout << "Warning: --time-limit and --node-limit only apply to --mode optimal\n";
+        }
         
         vector<int> solution;
         long long nodes = 0;
+        vector<WorkerStats> stats;
+        AnytimeResult anytime;
+        SearchStats search_record;
+        if(show_stats && !batch.two_phase) search_stats = &search_record;
         auto t0 = chrono::high_resolution_clock::now();
-        bool found = ida_star_solve_pdb(c, depth_limit, solution, nodes);
+        bool found = cache && cache->lookup(c, !batch.two_phase, solution)
+            && (batch.two_phase || (int)solution.size() <= depth_limit);
+        if(found) {
+            cout << "[OK] Solution found in cache\n";
+        } else if(batch.budgeted()) {
+            found = anytime_solve(c, depth_limit, batch.budget, anytime);
+            solution = anytime.solution;
+            nodes = anytime.nodes;
+            if(found && cache) cache->insert(c, anytime.optimal, solution);
+        } else {
+            found = batch.two_phase ? two_phase_solve(c, batch.two_phase_opt, solution, nodes)
+                : batch.mitm ? mitm_solve(c, depth_limit, batch.mitm_opt, solution, nodes)
+                : batch.par.threads > 1 ? ida_star_solve_pdb_parallel(c, depth_limit, batch.par, solution, nodes, stats)
+                : ida_star_solve_pdb(c, depth_limit, solution, nodes);
+            if(found && cache) cache->insert(c, !batch.two_phase, solution);
+        }
         auto t1 = chrono::high_resolution_clock::now();
+        search_stats = nullptr;
         
         cout << "Nodes explored: " << nodes << "\n";
+        if(anytime.exhausted) cout << "Fallback nodes: " << anytime.fallback_nodes << " (two-phase, after the budget)\n";
         cout << "Time: " << chrono::duration<double>(t1-t0).count() << " sec\n";
+        if(tt_megabytes > 0 && !batch.two_phase) print_tt_stats();
+        for(size_t i=0; i<stats.size(); i++) {
+            cout << "  Thread " << i << ": " << stats[i].nodes << " nodes, "
+                 << stats[i].tasks << " tasks, " << stats[i].steals << " stolen, "
+                 << stats[i].seconds << " sec\n";
+        }
+        if(show_stats && !search_record.iterations.empty()) {
+            search_record.print(cout);
+            if(!stats_json.empty()) {
+                ofstream out(stats_json);
+                out << search_record.json();
+                if(out) cout << "[OK] Wrote " << stats_json << "\n";
+                else cout << "Warning: Could not write " << stats_json << "\n";
+            }
+        }
         
+        if(anytime.exhausted) {
+            cout << "Budget spent: the optimal solution has at least " << anytime.lower_bound << " moves\n";
+        }
         if(found) {
-            cout << "Solution (" << solution.size() << " moves): " << seq_to_string(solution) << "\n";
+            cout << "Solution (" << solution.size() << " moves" << (anytime.exhausted && !anytime.optimal ? ", best effort" : "")
+                 << "): " << seq_to_string(solution) << "\n";
             
             CubieCube verify = c;
             for(int m : solution) {
@@ -436,9 +1358,19 @@ int main(int argc, char **argv) {
         } else {
             cout << "No solution found within depth limit\n";
         }
+        save_cache();
     } else {
         cout << "Phase 6: Pattern Database Solver\n";
-        cout << "Usage: " << argv[0] << " scramble N solve M\n";
+        cout << "Usage: " << argv[0] << " scramble N solve M [--seed S] [--threads T] [--split-depth D] [--deterministic]\n"
+             << "       [--pdb-populate] [--pdb-pages shared|thp|hugetlb] [--pdb-numa] [--verify-pdbs]\n"
+             << "       [--mode optimal|two-phase|mitm] [--target L] [--time-budget S]\n"
+             << "       [--mitm-depth K] [--mitm-mb MB] [--cache N] [--cache-file FILE] [--tt-mb MB] [--no-sym-lookups] [--bpmx]\n"
+             << "       [--dual off|lazy|eager] [--stats] [--stats-json FILE] [--time-limit S] [--node-limit N] [--progress]\n";
+        cout << "       " << argv[0] << " --self-check\n";
+        cout << "       " << argv[0] << " batch [--input FILE] [--format json|csv] [--order input|completion]\n"
+             << "       [--workers N] [--max-depth M] [--time-limit S] [--node-limit N]\n";
+        cout << "       " << argv[0] << " serve --socket PATH | --port N [--workers N] [--queue N] [--deadline S]\n"
+             << "       [--max-depth M] [--mode ...] [--cache N] [--cache-file FILE]\n";
         cout << "Example: " << argv[0] << " scramble 15 solve 20\n";
     }
     
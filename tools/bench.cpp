@@ -0,0 +1,445 @@
+// bench.cpp
+// Reproducible solver benchmark: fixed-seed and file-based corpora, per-group
+// throughput and latency, JSON output and a regression check against a saved run.
+// Build: the bench target of the top-level CMakeLists.txt
+// Usage: bench [--corpus depths|random|FILE]... --json run.json
+//        bench --compare baseline.json
+
+#include "../core/notation.h"
+#include "../core/options.h"
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+// ============================================================================
+// CORPORA
+// ============================================================================
+// A corpus is a list of named groups of positions. Generated groups depend only
+// on the seed: "depths" is --count scrambles of each length in --depths, and
+// "random" is --count uniformly random states (18 moves from solved on
+// average, so mostly for --mode two-phase). Any other --corpus is a file with
+// one position per line, in the solver's batch input format; its group is
+// named after the file. bench/corpora/hard.txt holds known 20-move positions.
+
+struct BenchGroup {
+    string name;
+    vector<CubieCube> cubes;
+};
+
+struct BenchOptions : SolverOptions {
+    vector<string> corpora;
+    vector<int> depths = {8, 10, 12};
+    int count = 20;
+    unsigned seed = 1;
+    int max_depth = 20;
+    string json_file;
+    string compare_file;
+    double tolerance = 0.10;
+    bool verbose = false;
+};
+
+bool load_corpus_file(const string &filename, BenchGroup &group) {
+    ifstream in(filename);
+    if(!in) {
+        cerr << "Error: could not open " << filename << "\n";
+        return false;
+    }
+    size_t slash = filename.find_last_of("/\\");
+    group.name = filename.substr(slash == string::npos ? 0 : slash + 1);
+    group.name = group.name.substr(0, group.name.rfind('.'));
+    string line;
+    int line_no = 0;
+    while(getline(in, line)) {
+        line_no++;
+        while(!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+        size_t start = line.find_first_not_of(' ');
+        if(start == string::npos || line[start] == '#') continue;
+        CubieCube c;
+        bool facelets;
+        string error;
+        if(!parse_position(line.substr(start), c, facelets, error)) {
+            cerr << "Error: " << filename << ":" << line_no << ": " << error << "\n";
+            return false;
+        }
+        group.cubes.push_back(c);
+    }
+    return true;
+}
+
+bool build_corpus(const BenchOptions &opt, vector<BenchGroup> &groups) {
+    for(const string &corpus : opt.corpora) {
+        if(corpus == "depths") {
+            for(int depth : opt.depths) {
+                BenchGroup g;
+                g.name = "depth" + to_string(depth);
+                for(int i=0; i<opt.count; i++) {
+                    CubieCube c;
+                    scramble_cube(c, depth, opt.seed + 1000003u * depth + i);
+                    g.cubes.push_back(c);
+                }
+                groups.push_back(move(g));
+            }
+        } else if(corpus == "random") {
+            BenchGroup g;
+            g.name = "random";
+            mt19937 rng(opt.seed);
+            for(int i=0; i<opt.count; i++) g.cubes.push_back(random_cube(rng));
+            groups.push_back(move(g));
+        } else {
+            BenchGroup g;
+            if(!load_corpus_file(corpus, g)) return false;
+            groups.push_back(move(g));
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// MEASUREMENT
+// ============================================================================
+
+struct GroupResult {
+    string name;
+    int solves = 0;
+    int solved = 0;
+    int failed = 0;            // a returned solution that does not solve the cube
+    long long nodes = 0;
+    double seconds = 0;
+    double mean_length = 0;
+    double p50 = 0, p90 = 0, p99 = 0, max_seconds = 0;
+
+    double nodes_per_solve() const { return solves ? (double)nodes / solves : 0; }
+    double nodes_per_sec() const { return seconds > 0 ? nodes / seconds : 0; }
+};
+
+// Nearest-rank percentile of sorted values
+double percentile(const vector<double> &sorted, double p) {
+    if(sorted.empty()) return 0;
+    size_t rank = (size_t)ceil(p / 100.0 * sorted.size());
+    return sorted[min(sorted.size(), max<size_t>(rank, 1)) - 1];
+}
+
+void summarize(GroupResult &r, vector<double> times, long long total_length) {
+    sort(times.begin(), times.end());
+    r.p50 = percentile(times, 50);
+    r.p90 = percentile(times, 90);
+    r.p99 = percentile(times, 99);
+    r.max_seconds = times.empty() ? 0 : times.back();
+    r.mean_length = r.solved ? (double)total_length / r.solved : 0;
+}
+
+GroupResult run_group(const BenchGroup &group, const BenchOptions &opt,
+                      vector<double> &all_times, long long &all_length) {
+    GroupResult r;
+    r.name = group.name;
+    vector<double> times;
+    long long total_length = 0;
+    for(size_t i=0; i<group.cubes.size(); i++) {
+        const CubieCube &c = group.cubes[i];
+        vector<int> solution;
+        long long nodes = 0;
+        vector<WorkerStats> stats;
+        auto t0 = chrono::steady_clock::now();
+        bool found = opt.two_phase ? two_phase_solve(c, opt.two_phase_opt, solution, nodes)
+            : opt.mitm ? mitm_solve(c, opt.max_depth, opt.mitm_opt, solution, nodes)
+            : opt.par.threads > 1 ? ida_star_solve_pdb_parallel(c, opt.max_depth, opt.par, solution, nodes, stats)
+            : ida_star_solve_pdb(c, opt.max_depth, solution, nodes);
+        double dt = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+        CubieCube check = c;
+        for(int m : solution) check = apply_move(check, m);
+        r.solves++;
+        if(found && check.is_solved()) {
+            r.solved++;
+            total_length += solution.size();
+        } else if(found) {
+            r.failed++;
+        }
+        r.nodes += nodes;
+        r.seconds += dt;
+        times.push_back(dt);
+        if(opt.verbose) {
+            cerr << group.name << " #" << i << ": " << (found ? (int)solution.size() : -1)
+                 << " moves, " << nodes << " nodes, " << dt << " sec\n";
+        }
+    }
+    all_times.insert(all_times.end(), times.begin(), times.end());
+    all_length += total_length;
+    summarize(r, times, total_length);
+    return r;
+}
+
+long peak_rss_kb() {
+#ifndef _WIN32
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024;   // bytes on macOS
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+#endif
+    return 0;
+}
+
+// ============================================================================
+// REPORTING
+// ============================================================================
+
+struct BenchReport {
+    double init_seconds = 0;
+    double pdb_load_seconds = 0;
+    MitmInfo mitm;
+    size_t pdb_bytes = 0;
+    size_t pdb_huge_bytes = 0;    // ... of them on 2 MB pages at the end of the run
+    long peak_rss_kb = 0;
+    vector<GroupResult> groups;
+    GroupResult total;
+};
+
+void print_table(const BenchReport &rep) {
+    cout << "\n" << left << setw(12) << "group" << right << setw(7) << "solved" << setw(14) << "nodes/solve"
+         << setw(13) << "nodes/sec" << setw(10) << "p50 s" << setw(10) << "p90 s" << setw(10) << "p99 s"
+         << setw(10) << "max s" << setw(8) << "len" << "\n";
+    auto row = [](const GroupResult &g) {
+        ostringstream solved;
+        solved << g.solved << "/" << g.solves;
+        cout << left << setw(12) << g.name << right << setw(7) << solved.str()
+             << fixed << setprecision(0) << setw(14) << g.nodes_per_solve() << setw(13) << g.nodes_per_sec()
+             << setprecision(4) << setw(10) << g.p50 << setw(10) << g.p90 << setw(10) << g.p99
+             << setw(10) << g.max_seconds << setprecision(1) << setw(8) << g.mean_length << "\n";
+        cout.unsetf(ios::floatfield);
+        cout << setprecision(6);
+    };
+    for(const auto &g : rep.groups) row(g);
+    row(rep.total);
+    cout << "\nTable init " << rep.init_seconds << " sec, PDB load " << rep.pdb_load_seconds
+         << " sec, peak RSS " << rep.peak_rss_kb / 1024.0 << " MB\n";
+    cout << "PDBs on 2 MB pages: " << rep.pdb_huge_bytes / 1048576.0 << " of " << rep.pdb_bytes / 1048576.0 << " MB\n";
+    if(rep.mitm.depth) {
+        cout << "Depth-" << rep.mitm.depth << " frontier: " << rep.mitm.states << " states, "
+             << rep.mitm.bytes / 1048576.0 << " MB, built in " << rep.mitm.build_seconds << " sec\n";
+    }
+    for(const auto &g : rep.groups) {
+        if(g.failed) cout << "[FAIL] " << g.name << ": " << g.failed << " solutions did not verify\n";
+    }
+}
+
+string group_json(const GroupResult &g) {
+    ostringstream out;
+    out << setprecision(9);
+    out << "{\"name\":\"" << g.name << "\",\"solves\":" << g.solves << ",\"solved\":" << g.solved
+        << ",\"failed\":" << g.failed << ",\"nodes\":" << g.nodes << ",\"seconds\":" << g.seconds
+        << ",\"nodes_per_solve\":" << g.nodes_per_solve() << ",\"nodes_per_sec\":" << g.nodes_per_sec()
+        << ",\"mean_length\":" << g.mean_length << ",\"p50_seconds\":" << g.p50
+        << ",\"p90_seconds\":" << g.p90 << ",\"p99_seconds\":" << g.p99
+        << ",\"max_seconds\":" << g.max_seconds << "}";
+    return out.str();
+}
+
+string report_json(const BenchReport &rep, const BenchOptions &opt) {
+    ostringstream out;
+    out << setprecision(9);
+    out << "{\"version\":1,\"seed\":" << opt.seed << ",\"mode\":\""
+        << (opt.two_phase ? "two-phase" : opt.mitm ? "mitm" : "optimal") << "\",\"threads\":" << opt.par.threads
+        << ",\"tt_mb\":" << tt_megabytes << ",\"sym_lookups\":" << (sym_lookups ? "true" : "false")
+        << ",\"bpmx\":" << (use_bpmx ? "true" : "false") << ",\"dual\":\""
+        << (dual_mode == DUAL_EAGER ? "eager" : dual_mode == DUAL_LAZY ? "lazy" : "off")
+        << "\",\"packed_impl\":\"" << packed_impl << "\",\"corners_sym\":" << (pdb_corners_sym ? "true" : "false")
+        << ",\"corners_mod3\":" << (pdb_corners_mod3 ? "true" : "false")
+        << ",\n \"init_seconds\":" << rep.init_seconds << ",\"pdb_load_seconds\":" << rep.pdb_load_seconds
+        << ",\"mitm_depth\":" << rep.mitm.depth << ",\"mitm_build_seconds\":" << rep.mitm.build_seconds
+        << ",\"pdb_pages\":\"" << (pdb_options.pages == PAGES_HUGETLB ? "hugetlb" : pdb_options.pages == PAGES_THP ? "thp" : "shared")
+        << "\",\"pdb_huge_mb\":" << rep.pdb_huge_bytes / 1048576.0
+        << ",\"peak_rss_kb\":" << rep.peak_rss_kb << ",\n \"groups\":[\n";
+    for(size_t i=0; i<rep.groups.size(); i++) {
+        out << "  " << group_json(rep.groups[i]) << (i + 1 < rep.groups.size() ? ",\n" : "\n");
+    }
+    out << " ],\n \"total\":" << group_json(rep.total) << "}\n";
+    return out.str();
+}
+
+// ============================================================================
+// COMPARE
+// ============================================================================
+// Reads back the JSON this tool writes: each group is a flat object, so a
+// field is found by scanning from the group's "name" to its closing brace.
+
+bool json_field(const string &obj, const string &key, double &value) {
+    size_t at = obj.find("\"" + key + "\":");
+    if(at == string::npos) return false;
+    value = strtod(obj.c_str() + at + key.size() + 3, nullptr);
+    return true;
+}
+
+bool json_group(const string &json, const string &name, string &obj) {
+    size_t at = json.find("{\"name\":\"" + name + "\"");
+    if(at == string::npos) return false;
+    obj = json.substr(at, json.find('}', at) - at + 1);
+    return true;
+}
+
+// Timings shorter than this are mostly scheduler noise: reported, never flagged
+const double MIN_TIMED_SECONDS = 0.05;
+
+// Returns the number of regressions beyond the tolerance
+int compare_reports(const string &baseline, const BenchReport &rep, double tolerance) {
+    // timing: the duration behind the metric, which must reach MIN_TIMED_SECONDS
+    struct Metric { const char *key; bool higher_is_better; const char *timing; };
+    const Metric metrics[] = {
+        {"nodes_per_solve", false, nullptr}, {"nodes_per_sec", true, "seconds"},
+        {"p50_seconds", false, "p50_seconds"}, {"p90_seconds", false, "p90_seconds"}};
+    int regressions = 0;
+    cout << "\nCompared with baseline (tolerance " << tolerance * 100 << "%):\n";
+    vector<GroupResult> all = rep.groups;
+    all.push_back(rep.total);
+    for(const auto &g : all) {
+        string base_obj;
+        if(!json_group(baseline, g.name, base_obj)) {
+            cout << "  " << g.name << ": not in baseline\n";
+            continue;
+        }
+        string cur_obj = group_json(g);
+        for(const Metric &m : metrics) {
+            double base, cur;
+            if(!json_field(base_obj, m.key, base) || !json_field(cur_obj, m.key, cur) || base <= 0) continue;
+            double change = cur / base - 1;
+            double base_t = 0, cur_t = 0;
+            bool judged = !m.timing || (json_field(base_obj, m.timing, base_t) && json_field(cur_obj, m.timing, cur_t)
+                                        && min(base_t, cur_t) >= MIN_TIMED_SECONDS);
+            bool worse = judged && (m.higher_is_better ? change < -tolerance : change > tolerance);
+            bool better = judged && (m.higher_is_better ? change > tolerance : change < -tolerance);
+            if(worse) regressions++;
+            cout << "  " << left << setw(12) << g.name << setw(16) << m.key << right
+                 << setw(14) << base << " -> " << setw(14) << cur << "  " << showpos << fixed
+                 << setprecision(1) << change * 100 << "%" << noshowpos;
+            cout.unsetf(ios::floatfield);
+            cout << setprecision(6) << (!judged ? "  (too short to time)" : worse ? "  REGRESSION"
+                                        : better ? "  improved" : "") << "\n";
+        }
+    }
+    double base_rss;
+    if(json_field(baseline, "peak_rss_kb", base_rss) && base_rss > 0
+       && rep.peak_rss_kb > base_rss * (1 + tolerance)) {
+        cout << "  peak RSS " << base_rss << " -> " << rep.peak_rss_kb << " KB  REGRESSION\n";
+        regressions++;
+    }
+    cout << (regressions ? "[FAIL] " : "[OK] ") << regressions << " regressions\n";
+    return regressions;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+vector<int> parse_int_list(const string &text) {
+    vector<int> out;
+    stringstream in(text);
+    string item;
+    while(getline(in, item, ',')) if(!item.empty()) out.push_back(stoi(item));
+    return out;
+}
+
+int main(int argc, char **argv) {
+    BenchOptions opt;
+    for(int i=1; i<argc; i++) {
+        string arg = argv[i];
+        if(arg == "--corpus" && i+1 < argc) {
+            opt.corpora.push_back(argv[++i]);
+        } else if(arg == "--depths" && i+1 < argc) {
+            opt.depths = parse_int_list(argv[++i]);
+        } else if(arg == "--count" && i+1 < argc) {
+            opt.count = max(1, stoi(argv[++i]));
+        } else if(arg == "--seed" && i+1 < argc) {
+            opt.seed = (unsigned)stoul(argv[++i]);
+        } else if(arg == "--max-depth" && i+1 < argc) {
+            opt.max_depth = stoi(argv[++i]);
+        } else if(parse_solver_option(argc, argv, i, opt)) {
+            continue;
+        } else if(arg == "--json" && i+1 < argc) {
+            opt.json_file = argv[++i];
+        } else if(arg == "--compare" && i+1 < argc) {
+            opt.compare_file = argv[++i];
+        } else if(arg == "--tolerance" && i+1 < argc) {
+            opt.tolerance = stod(argv[++i]);
+        } else if(arg == "--verbose") {
+            opt.verbose = true;
+        } else {
+            cout << "Solver benchmark\n";
+            cout << "Usage: " << argv[0] << " [--corpus depths|random|FILE]... [--depths 8,10,12] [--count N]\n"
+                 << "       [--seed S] [--mode optimal|two-phase|mitm] [--target L] [--time-budget S]\n"
+                 << "       [--mitm-depth K] [--mitm-mb MB] [--threads T] [--split-depth D] [--deterministic]\n"
+                 << "       [--max-depth M] [--tt-mb MB] [--no-sym-lookups] [--bpmx] [--dual off|lazy|eager] [--json FILE]\n"
+                 << "       [--compare BASELINE.json] [--pdb-populate] [--pdb-pages shared|thp|hugetlb] [--pdb-numa]\n"
+                 << "       [--verify-pdbs] [--tolerance F] [--verbose]\n";
+            cout << "Example: " << argv[0] << " --corpus depths --depths 10,12,13 --json base.json\n";
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if(opt.corpora.empty()) opt.corpora.push_back("depths");
+
+    string baseline;
+    if(!opt.compare_file.empty()) {
+        ifstream in(opt.compare_file);
+        if(!in) {
+            cerr << "Error: could not open " << opt.compare_file << "\n";
+            return 1;
+        }
+        baseline.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+
+    BenchReport rep;
+    auto t0 = chrono::steady_clock::now();
+    init_coord_tables();
+    init_sym_tables();
+    init_packed_cube();
+    init_move_fsm();
+    auto t1 = chrono::steady_clock::now();
+    load_pdbs();
+    auto t2 = chrono::steady_clock::now();
+    rep.init_seconds = chrono::duration<double>(t1 - t0).count();
+    rep.pdb_load_seconds = chrono::duration<double>(t2 - t1).count();
+    if(opt.mitm && !mitm_prepare(opt.mitm_opt, &rep.mitm)) {
+        cout << "Warning: --mitm-mb " << opt.mitm_opt.megabytes << " is too small for a frontier, using plain IDA*\n";
+    }
+
+    vector<BenchGroup> groups;
+    if(!build_corpus(opt, groups)) return 1;
+
+    vector<double> all_times;
+    long long all_length = 0;
+    rep.total.name = "total";
+    for(const auto &group : groups) {
+        GroupResult r = run_group(group, opt, all_times, all_length);
+        rep.total.solves += r.solves;
+        rep.total.solved += r.solved;
+        rep.total.failed += r.failed;
+        rep.total.nodes += r.nodes;
+        rep.total.seconds += r.seconds;
+        rep.groups.push_back(r);
+    }
+    summarize(rep.total, all_times, all_length);
+    rep.peak_rss_kb = peak_rss_kb();
+    // After the run, so a file mapping counts the pages the search touched
+    for(const PdbData *pdb : {&pdb_corners, &pdb_korf_a.data, &pdb_korf_b.data, &pdb_edges_a, &pdb_edges_b}) {
+        rep.pdb_bytes += pdb->bytes;
+        rep.pdb_huge_bytes += pdb_huge_bytes(*pdb);
+    }
+
+    print_table(rep);
+    if(tt_megabytes > 0 && !opt.two_phase) print_tt_stats();
+    if(!opt.json_file.empty()) {
+        ofstream out(opt.json_file);
+        out << report_json(rep, opt);
+        if(!out) {
+            cerr << "Error: could not write " << opt.json_file << "\n";
+            return 1;
+        }
+        cout << "[OK] Wrote " << opt.json_file << "\n";
+    }
+
+    int status = rep.total.failed ? 1 : 0;
+    if(!baseline.empty() && compare_reports(baseline, rep, opt.tolerance) > 0) status = 2;
+    return status;
+}
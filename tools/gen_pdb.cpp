@@ -1,246 +1,167 @@
 // gen_pdb.cpp
 // Phase 6: Pattern Database Generator using BFS
-// Compile: g++ -O2 -std=c++17 gen_pdb.cpp -o gen_pdb.exe
+// Build: the gen_pdb target of the top-level CMakeLists.txt (or see README.md)
 // Usage: gen_pdb.exe corners pdbs/corners.bin
+//        gen_pdb.exe corners_sym pdbs/corners_sym_mod3.bin --mod3
 //        gen_pdb.exe edges_a pdbs/edges_a.bin
 
-#include <bits/stdc++.h>
-using namespace std;
+#include "../core/pdb.h"
 
 // ============================================================================
-// CUBIE REPRESENTATION (copied from main solver)
-// ============================================================================
-
-struct CubieCube {
-    array<uint8_t,8> cp;
-    array<uint8_t,8> co;
-    array<uint8_t,12> ep;
-    array<uint8_t,12> eo;
-    
-    CubieCube(){ 
-        for(int i=0;i<8;i++){cp[i]=i; co[i]=0;} 
-        for(int i=0;i<12;i++){ep[i]=i; eo[i]=0;} 
-    }
-    
-    CubieCube operator*(const CubieCube &b) const {
-        CubieCube result;
-        for(int i=0; i<8; i++) {
-            result.cp[i] = cp[b.cp[i]];
-            result.co[i] = (co[b.cp[i]] + b.co[i]) % 3;
-        }
-        for(int i=0; i<12; i++) {
-            result.ep[i] = ep[b.ep[i]];
-            result.eo[i] = (eo[b.ep[i]] + b.eo[i]) % 2;
-        }
-        return result;
-    }
-};
-
-// ============================================================================
-// MOVE TABLES
-// ============================================================================
-
-CubieCube moveU() {
-    CubieCube c;
-    c.cp = {1, 2, 3, 0, 4, 5, 6, 7};
-    c.co = {0, 0, 0, 0, 0, 0, 0, 0};
-    c.ep = {1, 2, 3, 0, 4, 5, 6, 7, 8, 9, 10, 11};
-    c.eo = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-    return c;
-}
-
-CubieCube moveR() {
-    CubieCube c;
-    c.cp = {3, 1, 2, 7, 0, 5, 6, 4};
-    c.co = {2, 0, 0, 1, 1, 0, 0, 2};
-    c.ep = {11, 1, 2, 3, 8, 5, 6, 7, 0, 9, 10, 4};
-    c.eo = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-    return c;
-}
-
-CubieCube moveF() {
-    CubieCube c;
-    c.cp = {4, 0, 2, 3, 5, 1, 6, 7};
-    c.co = {1, 2, 0, 0, 2, 1, 0, 0};
-    c.ep = {0, 8, 2, 3, 4, 9, 6, 7, 5, 1, 10, 11};
-    c.eo = {0, 1, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0};
-    return c;
-}
-
-CubieCube moveD() {
-    CubieCube c;
-    c.cp = {0, 1, 2, 3, 7, 4, 5, 6};
-    c.co = {0, 0, 0, 0, 0, 0, 0, 0};
-    c.ep = {0, 1, 2, 3, 7, 4, 5, 6, 8, 9, 10, 11};
-    c.eo = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-    return c;
-}
-
-CubieCube moveL() {
-    CubieCube c;
-    c.cp = {0, 5, 1, 3, 4, 6, 2, 7};
-    c.co = {0, 1, 2, 0, 0, 2, 1, 0};
-    c.ep = {0, 1, 9, 3, 4, 5, 10, 7, 8, 6, 2, 11};
-    c.eo = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-    return c;
-}
-
-CubieCube moveB() {
-    CubieCube c;
-    c.cp = {0, 1, 6, 2, 4, 5, 7, 3};
-    c.co = {0, 0, 1, 2, 0, 0, 2, 1};
-    c.ep = {0, 1, 2, 10, 4, 5, 6, 11, 8, 9, 7, 3};
-    c.eo = {0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 1};
-    return c;
-}
-
-CubieCube moveTables[6];
-void init_move_tables() {
-    moveTables[0] = moveU();
-    moveTables[1] = moveR();
-    moveTables[2] = moveF();
-    moveTables[3] = moveD();
-    moveTables[4] = moveL();
-    moveTables[5] = moveB();
-}
-
-CubieCube apply_move(const CubieCube &cube, int move) {
-    int base = move % 6;
-    int count = 1;
-    if(move >= 6 && move < 12) count = 3;
-    else if(move >= 12) count = 2;
-    
-    CubieCube result = cube;
-    for(int i=0; i<count; i++) {
-        result = result * moveTables[base];
-    }
-    return result;
-}
-
-// ============================================================================
-// ENCODING FUNCTIONS
+// PDB GENERATION
 // ============================================================================
 
-const int factorial[13] = {1, 1, 2, 6, 24, 120, 720, 5040, 40320, 362880, 3628800, 39916800, 479001600};
-
-int encode_permutation_8(const array<uint8_t,8> &perm) {
-    int index = 0;
-    for(int i=0; i<8; i++) {
-        int smaller = 0;
-        for(int j=i+1; j<8; j++) {
-            if(perm[j] < perm[i]) smaller++;
-        }
-        index += smaller * factorial[7-i];
-    }
-    return index;
-}
-
-int encode_orientation_corners(const array<uint8_t,8> &ori) {
-    int index = 0;
-    for(int i=0; i<7; i++) {
-        index = index * 3 + ori[i];
-    }
-    return index;
+// Writes a corner table with one byte per state, or, for --mod3, packed
+// four states to the byte as depth mod 3
+bool write_corner_pdb(const string &filename, PdbScheme scheme, long long states,
+                      const vector<uint8_t> &pdb, int max_depth, bool mod3) {
+    vector<uint8_t> packed;
+    if(mod3) packed = pack_mod3(pdb);
+    const vector<uint8_t> &table = mod3 ? packed : pdb;
+    if(!write_pdb(filename, scheme, mod3 ? 2 : 8, states, table, max_depth)) return false;
+    cout << "[OK] Corner PDB saved (" << (table.size() / 1024.0 / 1024.0) << " MB"
+         << (mod3 ? ", 2-bit depth mod 3" : "") << ")\n";
+    return true;
 }
 
-// Edge subset encoding: choose 6 edges from 12, track their permutation and orientation
-// For edges_a: positions {0,1,2,3,4,5} (UR,UF,UL,UB,DR,DF)
-// For edges_b: positions {6,7,8,9,10,11} (DL,DB,FR,FL,BL,BR)
-
-int encode_edge_subset(const array<uint8_t,12> &ep, const array<uint8_t,12> &eo, 
-                       const array<int,6> &subset) {
-    // Extract permutation and orientation for subset
-    array<uint8_t,6> perm;
-    array<uint8_t,6> ori;
-    
-    for(int i=0; i<6; i++) {
-        perm[i] = ep[subset[i]];
-        ori[i] = eo[subset[i]];
-    }
-    
-    // Normalize permutation (map to 0..5)
-    array<uint8_t,6> normalized;
-    for(int i=0; i<6; i++) {
-        int rank = 0;
-        for(int j=0; j<6; j++) {
-            if(perm[j] < perm[i]) rank++;
-        }
-        normalized[i] = rank;
-    }
-    
-    // Encode permutation
-    int perm_idx = 0;
-    for(int i=0; i<6; i++) {
-        int smaller = 0;
-        for(int j=i+1; j<6; j++) {
-            if(normalized[j] < normalized[i]) smaller++;
-        }
-        perm_idx += smaller * factorial[5-i];
-    }
-    
-    // Encode orientation (first 5 bits)
-    int ori_idx = 0;
-    for(int i=0; i<5; i++) {
-        ori_idx = ori_idx * 2 + ori[i];
-    }
-    
-    return perm_idx * 32 + ori_idx;
-}
-
-// ============================================================================
-// PDB GENERATION
-// ============================================================================
-
-void generate_corner_pdb(const string &filename) {
-    cout << "Generating Corner PDB...\n";
+// Level-synchronous BFS over the depth table itself: no queue, memory is the
+// 84 MB table plus the move tables. Each level either expands the entries at
+// depth d (forward) or, once fewer states are unseen than were just found,
+// checks every unseen entry for a neighbour at depth d (backward). The scan is
+// split across threads in blocks of corner permutations; forward writes use
+// byte CAS, backward writes only touch the entry being scanned.
+bool generate_corner_pdb(const string &filename, int threads, bool mod3) {
+    cout << "Generating Corner PDB (" << threads << " threads)...\n";
     
     const int CORNER_STATES = 88179840;  // 8! * 3^7
     vector<uint8_t> pdb(CORNER_STATES, 255);
+    init_coord_tables();
     
     CubieCube solved;
-    int solved_idx = encode_permutation_8(solved.cp) * 2187 + encode_orientation_corners(solved.co);
+    int solved_idx = encode_permutation_8(solved.cp) * N_CORI + encode_orientation_corners(solved.co);
     pdb[solved_idx] = 0;
     
-    queue<pair<CubieCube, int>> q;
-    q.push({solved, 0});
-    
-    long long processed = 0;
-    int max_depth = 0;
+    uint8_t *table = pdb.data();
+    long long unseen = CORNER_STATES - 1;
+    long long frontier = 1;
+    int depth = 0;
     
-    while(!q.empty()) {
-        auto [state, depth] = q.front();
-        q.pop();
+    while(unseen > 0 && frontier > 0) {
+        bool backward = unseen < frontier;
+        atomic<int> next_block(0);
+        atomic<long long> found(0);
+        const int BLOCK = 64;  // corner permutations per work item
         
-        processed++;
-        if(processed % 1000000 == 0) {
-            cout << "Processed: " << processed << " / " << CORNER_STATES 
-                 << " (" << (100.0 * processed / CORNER_STATES) << "%)" 
-                 << " Depth: " << max_depth << "\n";
-        }
+        auto worker = [&]() {
+            long long local = 0;
+            int block;
+            while((block = next_block.fetch_add(1)) * BLOCK < N_CPERM) {
+                int cp_end = min(N_CPERM, (block + 1) * BLOCK);
+                for(int cp=block*BLOCK; cp<cp_end; cp++) {
+                    const uint16_t *cp_next = cperm_move[cp];
+                    for(int co=0; co<N_CORI; co++) {
+                        uint8_t *entry = table + cp * N_CORI + co;
+                        uint8_t v = __atomic_load_n(entry, __ATOMIC_RELAXED);
+                        if(backward) {
+                            if(v != 255) continue;
+                            for(int m=0; m<18; m++) {
+                                int next = cp_next[m] * N_CORI + cori_move[co][m];
+                                if(__atomic_load_n(table + next, __ATOMIC_RELAXED) == depth) {
+                                    __atomic_store_n(entry, (uint8_t)(depth + 1), __ATOMIC_RELAXED);
+                                    local++;
+                                    break;
+                                }
+                            }
+                        } else {
+                            if(v != depth) continue;
+                            for(int m=0; m<18; m++) {
+                                int next = cp_next[m] * N_CORI + cori_move[co][m];
+                                uint8_t expected = 255;
+                                if(__atomic_compare_exchange_n(table + next, &expected, (uint8_t)(depth + 1),
+                                                               false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                                    local++;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+            found += local;
+        };
         
-        for(int m=0; m<18; m++) {
-            CubieCube next = apply_move(state, m);
-            int idx = encode_permutation_8(next.cp) * 2187 + encode_orientation_corners(next.co);
-            
-            if(pdb[idx] == 255) {
-                pdb[idx] = depth + 1;
-                max_depth = max(max_depth, depth + 1);
-                q.push({next, depth + 1});
+        vector<thread> pool;
+        for(int t=0; t<threads; t++) pool.emplace_back(worker);
+        for(auto &th : pool) th.join();
+        
+        frontier = found.load();
+        if(frontier == 0) break;
+        unseen -= frontier;
+        depth++;
+        cout << "Depth " << depth << ": " << frontier << " states"
+             << (backward ? " (backward)" : "") << ", " << unseen << " unseen\n";
+    }
+    
+    cout << "Corner PDB complete! Max depth: " << depth << "\n";
+    cout << "Saving to " << filename << "...\n";
+    
+    return write_corner_pdb(filename, SCHEME_CORNERS, CORNER_STATES, pdb, depth, mod3);
+}
+
+// Symmetry-reduced corner PDB: one entry per (cperm class, conjugated cori).
+// Each entry stands for a real state - the class representative with that
+// twist - so the scan expands it directly and files every child under its
+// own class. A representative fixed by some symmetries has several entries
+// for one state class, and the solver may land on any of them, so a newly
+// reached entry is written to all of them. 6 MB, same values as the full table.
+bool generate_corner_sym_pdb(const string &filename, bool mod3) {
+    cout << "Generating symmetry-reduced Corner PDB...\n";
+    
+    const long long STATES = (long long)N_CPERM_CLASS * N_CORI;
+    vector<uint8_t> pdb(STATES, 255);
+    init_coord_tables();
+    init_sym_tables();
+    
+    auto index = [&](int cp, int co) {
+        return (long long)cperm_class[cp] * N_CORI + cori_conj[co][cperm_sym[cp]];
+    };
+    pdb[index(0, 0)] = 0;
+    
+    long long filled = 1;
+    int depth = 0;
+    while(true) {
+        long long found = 0;
+        for(long long idx=0; idx<STATES; idx++) {
+            if(pdb[idx] != depth) continue;
+            int cp = cperm_rep[idx / N_CORI], co = idx % N_CORI;
+            for(int m=0; m<18; m++) {
+                long long next = index(cperm_move[cp][m], cori_move[co][m]);
+                if(pdb[next] != 255) continue;
+                long long base = next - next % N_CORI;
+                int stab = cperm_rep_stab[next / N_CORI];
+                for(int s=0; s<N_SYM_UD; s++) {
+                    if(!(stab >> s & 1)) continue;
+                    long long twin = base + cori_conj[next % N_CORI][s];
+                    if(pdb[twin] == 255) {
+                        pdb[twin] = depth + 1;
+                        found++;
+                    }
+                }
             }
         }
+        if(found == 0) break;
+        depth++;
+        filled += found;
+        cout << "Depth " << depth << ": " << found << " entries ("
+             << (100.0 * filled / STATES) << "%)\n";
     }
     
-    cout << "Corner PDB complete! Max depth: " << max_depth << "\n";
+    cout << "Corner PDB complete! Max depth: " << depth << "\n";
     cout << "Saving to " << filename << "...\n";
     
-    ofstream out(filename, ios::binary);
-    out.write(reinterpret_cast<const char*>(pdb.data()), pdb.size());
-    out.close();
-    
-    cout << "[OK] Corner PDB saved (" << (pdb.size() / 1024.0 / 1024.0) << " MB)\n";
+    return write_corner_pdb(filename, SCHEME_CORNERS_SYM, STATES, pdb, depth, mod3);
 }
 
-void generate_edge_pdb(const string &filename, const string &subset_name) {
+bool generate_edge_pdb(const string &filename, const string &subset_name) {
     cout << "Generating Edge PDB (" << subset_name << ")...\n";
     
     array<int,6> subset;
@@ -284,11 +205,112 @@ void generate_edge_pdb(const string &filename, const string &subset_name) {
     cout << "Edge PDB complete! Max depth: " << max_depth << "\n";
     cout << "Saving to " << filename << "...\n";
     
-    ofstream out(filename, ios::binary);
-    out.write(reinterpret_cast<const char*>(pdb.data()), pdb.size());
-    out.close();
+    PdbScheme scheme = subset_name == "edges_a" ? SCHEME_EDGES_A : SCHEME_EDGES_B;
+    if(!write_pdb(filename, scheme, 8, EDGE_STATES, pdb)) return false;
     
     cout << "[OK] Edge PDB saved (" << (pdb.size() / 1024.0) << " KB)\n";
+    return true;
+}
+
+// Korf edge PDB: 4-bit entries (two per byte, low nibble first), 0xF = unseen.
+// The table is expanded level by level by scanning it for entries at depth d,
+// so no queue is needed for the 42.5M / 510M state spaces.
+bool generate_korf_edge_pdb(const string &filename, int k, int first, PdbScheme scheme) {
+    cout << "Generating Korf Edge PDB (" << k << " edges, cubies " << first
+         << "-" << (first + k - 1) << ")...\n";
+    
+    init_coord_tables();
+    
+    const long long STATES = korf_edge_states(k);
+    vector<uint8_t> pdb((STATES + 1) / 2, 0xFF);
+    auto get = [&](long long idx) { return (pdb[idx >> 1] >> ((idx & 1) << 2)) & 0xF; };
+    auto set = [&](long long idx, int v) {
+        int shift = (idx & 1) << 2;
+        pdb[idx >> 1] = (pdb[idx >> 1] & ~(0xF << shift)) | (v << shift);
+    };
+    
+    uint8_t pos[7], ori[7];
+    for(int i=0; i<k; i++) { pos[i] = first + i; ori[i] = 0; }
+    set(encode_edge_korf(pos, ori, k), 0);
+    
+    long long filled = 1;
+    int depth = 0;
+    while(true) {
+        long long found = 0;
+        for(long long idx=0; idx<STATES; idx++) {
+            if(get(idx) != depth) continue;
+            decode_edge_korf(idx, k, pos, ori);
+            for(int m=0; m<18; m++) {
+                uint8_t npos[7], nori[7];
+                for(int i=0; i<k; i++) {
+                    npos[i] = edge_to[m][pos[i]];
+                    nori[i] = ori[i] ^ edge_flip[m][pos[i]];
+                }
+                long long next = encode_edge_korf(npos, nori, k);
+                if(get(next) == 0xF) {
+                    set(next, depth + 1);
+                    found++;
+                }
+            }
+        }
+        if(found == 0) break;
+        depth++;
+        filled += found;
+        cout << "Depth " << depth << ": " << found << " states (" 
+             << (100.0 * filled / STATES) << "%)\n";
+    }
+    
+    cout << "Korf Edge PDB complete! Max depth: " << depth << "\n";
+    cout << "Saving to " << filename << "...\n";
+    
+    if(!write_pdb(filename, scheme, 4, STATES, pdb)) return false;
+    
+    cout << "[OK] Korf Edge PDB saved (" << (pdb.size() / 1024.0 / 1024.0) << " MB)\n";
+    return true;
+}
+
+// Wrap a headerless .bin from an older gen_pdb in the versioned format
+bool convert_raw_pdb(const string &type, const string &in_name, const string &out_name) {
+    struct RawType { const char *name; PdbScheme scheme; int bits; long long states; };
+    const RawType types[] = {
+        {"corners", SCHEME_CORNERS, 8, 88179840},
+        {"edges_a", SCHEME_EDGES_A, 8, 23040},
+        {"edges_b", SCHEME_EDGES_B, 8, 23040},
+        {"edges6_a", SCHEME_EDGES6_A, 4, korf_edge_states(6)},
+        {"edges6_b", SCHEME_EDGES6_B, 4, korf_edge_states(6)},
+        {"edges7_a", SCHEME_EDGES7_A, 4, korf_edge_states(7)},
+        {"edges7_b", SCHEME_EDGES7_B, 4, korf_edge_states(7)},
+    };
+    const RawType *t = nullptr;
+    for(const auto &rt : types) if(type == rt.name) t = &rt;
+    if(!t) {
+        cout << "Unknown PDB type: " << type << "\n";
+        return false;
+    }
+    
+    long long expected = t->bits == 4 ? (t->states + 1) / 2 : t->states;
+    ifstream in(in_name, ios::binary | ios::ate);
+    if(!in) {
+        cout << "Error: could not open " << in_name << "\n";
+        return false;
+    }
+    long long file_size = in.tellg();
+    if(file_size != expected) {
+        cout << "Error: " << in_name << " is " << file_size << " bytes, expected " << expected
+             << " for a raw " << type << " table\n";
+        return false;
+    }
+    vector<uint8_t> pdb(expected);
+    in.seekg(0);
+    if(!in.read(reinterpret_cast<char*>(pdb.data()), expected)) {
+        cout << "Error: short read from " << in_name << "\n";
+        return false;
+    }
+    in.close();
+    
+    if(!write_pdb(out_name, t->scheme, t->bits, t->states, pdb)) return false;
+    cout << "[OK] Converted " << in_name << " -> " << out_name << "\n";
+    return true;
 }
 
 // ============================================================================
@@ -299,32 +321,73 @@ int main(int argc, char **argv) {
     if(argc < 3) {
         cout << "Pattern Database Generator\n";
         cout << "Usage:\n";
-        cout << "  " << argv[0] << " corners <output_file>\n";
+        cout << "  " << argv[0] << " corners <output_file> [--threads N] [--mod3]\n";
+        cout << "  " << argv[0] << " corners_sym <output_file> [--mod3]\n";
         cout << "  " << argv[0] << " edges_a <output_file>\n";
         cout << "  " << argv[0] << " edges_b <output_file>\n";
+        cout << "  " << argv[0] << " edges6_a|edges6_b|edges7_a|edges7_b <output_file>\n";
+        cout << "  " << argv[0] << " convert <type> <raw_input.bin> <output_file>\n";
         cout << "\nExample:\n";
         cout << "  " << argv[0] << " corners pdbs/corners.bin\n";
+        cout << "  " << argv[0] << " corners_sym pdbs/corners_sym.bin\n";
+        cout << "  " << argv[0] << " corners_sym pdbs/corners_sym_mod3.bin --mod3\n";
         cout << "  " << argv[0] << " edges_a pdbs/edges_a.bin\n";
         cout << "  " << argv[0] << " edges_b pdbs/edges_b.bin\n";
+        cout << "  " << argv[0] << " edges7_a pdbs/edges7_a.bin\n";
+        cout << "  " << argv[0] << " convert corners old/corners.bin pdbs/corners.bin\n";
         return 1;
     }
     
-    init_move_tables();
-    
     string type = argv[1];
     string filename = argv[2];
     
+    if(type == "convert") {
+        if(argc < 5) {
+            cout << "Usage: " << argv[0] << " convert <type> <raw_input.bin> <output_file>\n";
+            return 1;
+        }
+        return convert_raw_pdb(argv[2], argv[3], argv[4]) ? 0 : 1;
+    }
+    
+    int threads = max(1u, thread::hardware_concurrency());
+    bool mod3 = false;   // 2-bit entries holding depth mod 3; the solver recovers the depth
+    for(int i=3; i<argc; i++) {
+        string arg = argv[i];
+        if(arg == "--threads" && i+1 < argc) threads = max(1, stoi(argv[++i]));
+        else if(arg == "--mod3") mod3 = true;
+    }
+    if(mod3 && type != "corners" && type != "corners_sym") {
+        cout << "--mod3 is only supported for corners and corners_sym\n";
+        return 1;
+    }
+    
     auto start = chrono::high_resolution_clock::now();
     
+    bool ok;
     if(type == "corners") {
-        generate_corner_pdb(filename);
+        ok = generate_corner_pdb(filename, threads, mod3);
+    } else if(type == "corners_sym") {
+        ok = generate_corner_sym_pdb(filename, mod3);
     } else if(type == "edges_a") {
-        generate_edge_pdb(filename, "edges_a");
+        ok = generate_edge_pdb(filename, "edges_a");
     } else if(type == "edges_b") {
-        generate_edge_pdb(filename, "edges_b");
+        ok = generate_edge_pdb(filename, "edges_b");
+    } else if(type == "edges6_a") {
+        ok = generate_korf_edge_pdb(filename, 6, 0, SCHEME_EDGES6_A);
+    } else if(type == "edges6_b") {
+        ok = generate_korf_edge_pdb(filename, 6, 6, SCHEME_EDGES6_B);
+    } else if(type == "edges7_a") {
+        ok = generate_korf_edge_pdb(filename, 7, 0, SCHEME_EDGES7_A);
+    } else if(type == "edges7_b") {
+        ok = generate_korf_edge_pdb(filename, 7, 5, SCHEME_EDGES7_B);
     } else {
         cout << "Unknown PDB type: " << type << "\n";
-        cout << "Use: corners, edges_a, or edges_b\n";
+        cout << "Use: corners, corners_sym, edges_a, edges_b, edges6_a, edges6_b, edges7_a or edges7_b\n";
+        return 1;
+    }
+    
+    if(!ok) {
+        cout << "[FAIL] " << filename << " was not written\n";
         return 1;
     }
     